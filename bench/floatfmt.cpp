@@ -0,0 +1,74 @@
+/* Benchmark of writing doubles: the stream (<<) at its default and at
+ * full precision against xmlserial's shortest round-trip formatting.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++17 -I. bench/floatfmt.cpp -o floatfmt
+ * (with -std=c++11 the formatter falls back to printf-style conversion)
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+#include <ctime>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+
+static double seconds() {
+	return double(clock())/CLOCKS_PER_SEC;
+}
+
+static void report(const char *name, double t, std::size_t nbytes,
+			std::size_t n) {
+	std::cout << std::setw(24) << std::left << name
+		<< std::setw(10) << std::right << std::fixed << std::setprecision(1)
+		<< nbytes/t/1e6 << " MB/s"
+		<< std::setw(10) << n/t/1e6 << " Mvalues/s"
+		<< std::setw(12) << nbytes << " bytes" << std::endl;
+}
+
+int main(int argc, char **argv) {
+	std::size_t n = argc>1 ? atol(argv[1]) : 2000000;
+	std::vector<double> v(n);
+	srand(1);
+	for(std::size_t i=0;i<n;i++)
+		v[i] = (rand()-RAND_MAX/2)/double(rand()+1);
+
+	{
+		std::ostringstream os;
+		double t = seconds();
+		for(std::size_t i=0;i<n;i++) os << v[i] << ' ';
+		report("<< (precision 6)",seconds()-t,os.str().size(),n);
+	}
+	{
+		std::ostringstream os;
+		os << std::setprecision(17);
+		double t = seconds();
+		for(std::size_t i=0;i<n;i++) os << v[i] << ' ';
+		report("<< (precision 17)",seconds()-t,os.str().size(),n);
+	}
+	{
+		std::ostringstream os;
+		double t = seconds();
+		for(std::size_t i=0;i<n;i++) {
+			xmlserial::WriteNum(os,v[i]);
+			os << ' ';
+		}
+		report("shortest",seconds()-t,os.str().size(),n);
+	}
+	{
+		std::ostringstream os;
+		os << xmlserial::streamfloats << std::setprecision(17);
+		double t = seconds();
+		xmlserial::Save(v,os);
+		report("Save (precision 17)",seconds()-t,os.str().size(),n);
+	}
+	{
+		std::ostringstream os;
+		double t = seconds();
+		xmlserial::Save(v,os);
+		report("Save (shortest)",seconds()-t,os.str().size(),n);
+	}
+	return 0;
+}
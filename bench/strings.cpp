@@ -0,0 +1,64 @@
+/* Benchmark of loading long strings: the character-at-a-time ReadStr
+ * against the block-at-a-time loading used for string elements, for
+ * strings of 1 KB, 64 KB, and 16 MB (about one in 50 characters needs
+ * escaping).
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -I. bench/strings.cpp -o strings
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <ctime>
+#include "xmlserial.h"
+#include "xmlserial_string.h"
+
+static double seconds() {
+	return double(clock())/CLOCKS_PER_SEC;
+}
+
+static void report(const char *name, std::size_t len, double t,
+			std::size_t nbytes) {
+	std::cout << std::setw(16) << std::left << name
+		<< std::setw(10) << std::right << len << " chars"
+		<< std::setw(10) << std::fixed << std::setprecision(1)
+		<< nbytes/t/1e6 << " MB/s" << std::endl;
+}
+
+int main() {
+	const char *text = "The quick brown fox jumps over the lazy dog & ";
+	const std::size_t lens[] = { 1<<10, 1<<16, 1<<24 };
+	const std::size_t total = 1<<26; // bytes loaded per size
+
+	for(int k=0;k<3;k++) {
+		std::string s(lens[k],' ');
+		for(std::size_t i=0;i<s.length();i++) s[i] = text[i%46];
+		std::ostringstream os;
+		xmlserial::Save(s,os);
+		const std::string saved = os.str();
+		std::size_t reps = total/lens[k];
+
+		// the body alone, read as ReadStr does it
+		std::string::size_type b = saved.find('>')+1;
+		const std::string body = saved.substr(b,saved.find("<\\")-b)+"<";
+		double t = seconds();
+		for(std::size_t r=0;r<reps;r++) {
+			std::istringstream is(body);
+			std::string l;
+			xmlserial::ReadStr(is,l,"<");
+		}
+		report("ReadStr",lens[k],seconds()-t,reps*lens[k]);
+
+		t = seconds();
+		for(std::size_t r=0;r<reps;r++) {
+			std::istringstream is(saved);
+			std::string l;
+			xmlserial::Load(l,is);
+		}
+		report("Load",lens[k],seconds()-t,reps*lens[k]);
+	}
+	return 0;
+}
@@ -0,0 +1,358 @@
+/* Benchmark suite: saving and loading of synthetic workloads, each timed
+ * separately for save and load.
+ *
+ *   flat        vector of structs of 16 scalar members
+ *   vecdouble   vector<double> (1K elements up to --max)
+ *   vecint      vector<int> (likewise)
+ *   map         map<string,struct>
+ *   deep        chain of nested objects, 1000 deep
+ *   strplain    vector of 100-character strings without escapes
+ *   stresc      vector of 100-character strings with escapes
+ *   ptrgraph    polymorphic shared_ptr graph with heavy aliasing,
+ *               through an archive
+ *
+ * For each, it reports the bytes of text, MB/s, objects/s, heap
+ * allocations per run, and the peak resident set size so far.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. bench/suite.cpp -o suite
+ *
+ * Usage:  suite [--csv] [--max N] [--only NAME]
+ *   --csv    one comma-separated line per measurement (after a header)
+ *   --max N  largest vector size (default 1000000; up to 100000000 needs
+ *            several GB of memory)
+ *   --only   run only the named workload
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_map.h"
+#include "xmlserial_string.h"
+
+// counts heap allocations (replacing every form of new and delete but the
+// aligned ones, so that all memory from these comes from malloc)
+static std::size_t nallocs = 0;
+
+// (GCC, inlining these, takes the free of memory from new to be a mismatch)
+#if defined(__GNUC__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void *operator new(std::size_t n) {
+	nallocs++;
+	void *p = malloc(n ? n : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+void *operator new[](std::size_t n) { return operator new(n); }
+void *operator new(std::size_t n, const std::nothrow_t &) noexcept {
+	nallocs++;
+	return malloc(n ? n : 1);
+}
+void *operator new[](std::size_t n, const std::nothrow_t &t) noexcept {
+	return operator new(n,t);
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, std::size_t) noexcept { free(p); }
+void operator delete[](void *p, std::size_t) noexcept { free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { free(p); }
+#if defined(__GNUC__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+// peak resident set size (in KB) so far
+static long peakrss() {
+#if defined(__unix__) || defined(__APPLE__)
+	struct rusage ru;
+	getrusage(RUSAGE_SELF,&ru);
+#ifdef __APPLE__
+	return ru.ru_maxrss/1024;
+#else
+	return ru.ru_maxrss;
+#endif
+#else
+	return 0;
+#endif
+}
+
+static double seconds() {
+	return std::chrono::duration<double>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//-------------------------------------------------------------------
+// workload types
+
+struct Flat {
+	int i1, i2, i3, i4;
+	long l1, l2;
+	unsigned u1, u2;
+	short s1;
+	bool b1, b2;
+	float f1, f2;
+	double d1, d2, d3;
+	XMLSERIALCLASS(Flat,,i1,i2,i3,i4,l1,l2,u1,u2,s1,b1,b2,f1,f2,d1,d2,d3)
+};
+
+struct Rec {
+	int id;
+	double score;
+	std::string name;
+	XMLSERIALCLASS(Rec,,id,score,name)
+};
+
+struct Deep {
+	int v;
+	std::vector<Deep> inner; // one element, except at the bottom
+	XMLSERIALCLASS(Deep,,v,inner)
+};
+
+struct Shape {
+	int id;
+	Shape() : id(0) {}
+	virtual ~Shape() {}
+	XMLSERIALCLASS_P(Shape,,id)
+};
+
+struct Leaf : public Shape {
+	double w;
+	Leaf() : w(0) {}
+	XMLSERIALCLASS_P(Leaf,Shape,w)
+};
+
+struct Group : public Shape {
+	std::vector<std::shared_ptr<Shape> > parts;
+	XMLSERIALCLASS_P(Group,Shape,parts)
+};
+
+struct Graph {
+	std::vector<std::shared_ptr<Shape> > nodes;
+	XMLSERIALCLASS(Graph,,nodes)
+};
+
+//-------------------------------------------------------------------
+// measurement
+
+static bool csv = false;
+
+static void report(const std::string &work, std::size_t size,
+		const char *phase, std::size_t nbytes, std::size_t nobj,
+		double t, std::size_t allocs) {
+	if (csv) {
+		std::cout << work << ',' << size << ',' << phase << ','
+			<< nbytes << ',' << t << ',' << nbytes/t/1e6 << ','
+			<< nobj/t << ',' << allocs << ',' << peakrss() << '\n';
+		return;
+	}
+	std::cout << std::setw(10) << std::left << work
+		<< std::setw(11) << std::right << size
+		<< std::setw(6) << phase
+		<< std::setw(12) << nbytes << " B"
+		<< std::fixed << std::setprecision(1)
+		<< std::setw(9) << nbytes/t/1e6 << " MB/s"
+		<< std::setprecision(0)
+		<< std::setw(12) << nobj/t << " obj/s"
+		<< std::setw(11) << allocs << " allocs"
+		<< std::setw(9) << peakrss() << " KB" << std::endl;
+}
+
+// saves and then loads v (as type T) repeatedly, for at least a fraction
+// of a second each; nobj is the number of objects in v
+template<typename T>
+static void run(const std::string &work, std::size_t size, const T &v,
+		std::size_t nobj, bool witharchive) {
+	const double mintime = 0.25;
+	std::string text;
+	int reps = 0;
+	std::size_t allocs = nallocs;
+	double t = seconds(), t0 = t;
+	do {
+		std::ostringstream os;
+		if (witharchive) {
+			xmlserial::archive a(os);
+			xmlserial::Save(v,a);
+		} else xmlserial::Save(v,os);
+		if (!reps) text = os.str();
+		reps++;
+		t = seconds();
+	} while(t-t0<mintime);
+	report(work,size,"save",text.size(),nobj,(t-t0)/reps,
+		(nallocs-allocs)/reps);
+
+	reps = 0;
+	allocs = nallocs;
+	t0 = t = seconds();
+	do {
+		T r;
+		std::istringstream is(text);
+		if (witharchive) {
+			xmlserial::archive a(is);
+			xmlserial::Load(r,a);
+		} else xmlserial::Load(r,is);
+		reps++;
+		t = seconds();
+	} while(t-t0<mintime);
+	report(work,size,"load",text.size(),nobj,(t-t0)/reps,
+		(nallocs-allocs)/reps);
+}
+
+//-------------------------------------------------------------------
+// workload generators
+
+static std::vector<Flat> makeflat(std::size_t n) {
+	std::vector<Flat> v(n);
+	for(std::size_t i=0;i<n;i++) {
+		Flat &f = v[i];
+		f.i1 = rand(); f.i2 = -rand(); f.i3 = i; f.i4 = rand()%100;
+		f.l1 = rand()*1000L; f.l2 = -(long)i;
+		f.u1 = rand(); f.u2 = i*7;
+		f.s1 = rand()%1000;
+		f.b1 = i%2; f.b2 = i%3==0;
+		f.f1 = rand()/1000.0f; f.f2 = 0.5f*i;
+		f.d1 = rand()/double(RAND_MAX); f.d2 = i*0.25; f.d3 = -1e10/(i+1);
+	}
+	return v;
+}
+
+static std::vector<double> makedoubles(std::size_t n) {
+	std::vector<double> v(n);
+	for(std::size_t i=0;i<n;i++)
+		v[i] = (rand()-RAND_MAX/2)/double(rand()+1);
+	return v;
+}
+
+static std::vector<int> makeints(std::size_t n) {
+	std::vector<int> v(n);
+	for(std::size_t i=0;i<n;i++) v[i] = rand()-RAND_MAX/2;
+	return v;
+}
+
+static std::map<std::string,Rec> makemap(std::size_t n) {
+	std::map<std::string,Rec> m;
+	for(std::size_t i=0;i<n;i++) {
+		std::ostringstream k;
+		k << "key" << rand() << '_' << i;
+		Rec &r = m[k.str()];
+		r.id = i;
+		r.score = rand()/double(RAND_MAX);
+		r.name = "record number " + k.str();
+	}
+	return m;
+}
+
+static Deep makedeep(int depth) {
+	Deep d;
+	d.v = depth;
+	if (depth>1) d.inner.push_back(makedeep(depth-1));
+	return d;
+}
+
+static std::vector<std::string> makestrings(std::size_t n, bool esc) {
+	const char *plain = "abcdefghijklmnopqrstuvwxyz0123456789 ";
+	const char *special = "<>&\"'";
+	std::vector<std::string> v(n);
+	for(std::size_t i=0;i<n;i++) {
+		v[i].resize(100);
+		for(int j=0;j<100;j++)
+			v[i][j] = esc && rand()%10==0 ? special[rand()%5]
+				: plain[rand()%37];
+	}
+	return v;
+}
+
+// n nodes, each group referring to up to 8 earlier nodes (so each node
+// is pointed to several times)
+static Graph makegraph(std::size_t n) {
+	Graph g;
+	for(std::size_t i=0;i<n;i++) {
+		if (i<16 || rand()%2) {
+			std::shared_ptr<Leaf> l = std::make_shared<Leaf>();
+			l->id = i;
+			l->w = rand()/double(RAND_MAX);
+			g.nodes.push_back(l);
+		} else {
+			std::shared_ptr<Group> gr = std::make_shared<Group>();
+			gr->id = i;
+			int k = 1+rand()%8;
+			for(int j=0;j<k;j++)
+				gr->parts.push_back(g.nodes[rand()%i]);
+			g.nodes.push_back(gr);
+		}
+	}
+	return g;
+}
+
+//-------------------------------------------------------------------
+
+int main(int argc, char **argv) {
+	std::size_t maxn = 1000000;
+	std::string only;
+	for(int i=1;i<argc;i++) {
+		if (!strcmp(argv[i],"--csv")) csv = true;
+		else if (!strcmp(argv[i],"--max") && i+1<argc)
+			maxn = strtoul(argv[++i],0,10);
+		else if (!strcmp(argv[i],"--only") && i+1<argc)
+			only = argv[++i];
+		else {
+			std::cerr << "usage: " << argv[0]
+				<< " [--csv] [--max N] [--only NAME]" << std::endl;
+			return 1;
+		}
+	}
+	if (csv)
+		std::cout << "workload,size,phase,bytes,seconds,mbps,objps,"
+			"allocs,peakrsskb\n";
+	srand(1);
+
+	if (only.empty() || only=="flat") {
+		std::vector<Flat> v = makeflat(100000);
+		run("flat",v.size(),v,v.size(),false);
+	}
+	for(std::size_t n=1000;n<=maxn;n*=100) {
+		if (only.empty() || only=="vecdouble") {
+			std::vector<double> v = makedoubles(n);
+			run("vecdouble",n,v,n,false);
+		}
+		if (only.empty() || only=="vecint") {
+			std::vector<int> v = makeints(n);
+			run("vecint",n,v,n,false);
+		}
+	}
+	if (only.empty() || only=="map") {
+		std::map<std::string,Rec> m = makemap(100000);
+		run("map",m.size(),m,m.size(),false);
+	}
+	if (only.empty() || only=="deep") {
+		Deep d = makedeep(1000);
+		run("deep",1000,d,1000,false);
+	}
+	if (only.empty() || only=="strplain") {
+		std::vector<std::string> v = makestrings(100000,false);
+		run("strplain",v.size(),v,v.size(),false);
+	}
+	if (only.empty() || only=="stresc") {
+		std::vector<std::string> v = makestrings(100000,true);
+		run("stresc",v.size(),v,v.size(),false);
+	}
+	if (only.empty() || only=="ptrgraph") {
+		Graph g = makegraph(100000);
+		run("ptrgraph",g.nodes.size(),g,g.nodes.size(),true);
+	}
+	return 0;
+}
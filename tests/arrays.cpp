@@ -0,0 +1,113 @@
+/* Test of std::arrays and C arrays (xmlserial_array.h and
+ * xmlserial_carray.h):  arrays of numbers, and arrays of arrays of them,
+ * round trip as text and in bulk (where arrays of arrays are a single run
+ * of numbers), arrays of classes round trip element by element, and
+ * the wrong number of elements is an error.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/arrays.cpp -o arrays
+ */
+
+#include <string>
+#include <array>
+#include <sstream>
+#include "xmlserial.h"
+#include "xmlserial_array.h"
+#include "xmlserial_carray.h"
+#include "check.h"
+
+struct Pt {
+	int x, y;
+	XMLSERIALCLASS(Pt,,x,y)
+};
+
+struct Grid {
+	double m[4][5];
+	std::array<std::array<float,3>,7> v;
+	std::array<int,2> pair;
+	short s[3];
+	Pt corners[2];
+	std::array<Pt,3> path;
+	XMLSERIALCLASS(Grid,,m,v,pair,s,corners,path)
+};
+
+static void fill(Grid &g, int seed) {
+	for(int i=0;i<4;i++) for(int j=0;j<5;j++) g.m[i][j] = seed+i*0.5-j*1e-7;
+	for(int i=0;i<7;i++) for(int j=0;j<3;j++) g.v[i][j] = float(seed*i)/(j+3);
+	g.pair[0] = -seed;
+	g.pair[1] = seed;
+	for(int i=0;i<3;i++) g.s[i] = short(seed-i);
+	for(int i=0;i<2;i++) {
+		g.corners[i].x = seed+i;
+		g.corners[i].y = seed-i;
+	}
+	for(int i=0;i<3;i++) {
+		g.path[i].x = i;
+		g.path[i].y = seed*i;
+	}
+}
+
+static bool same(const Grid &a, const Grid &b) {
+	for(int i=0;i<4;i++) for(int j=0;j<5;j++)
+		if (a.m[i][j]!=b.m[i][j]) return false;
+	for(int i=0;i<3;i++) if (a.s[i]!=b.s[i]) return false;
+	for(int i=0;i<2;i++)
+		if (a.corners[i].x!=b.corners[i].x || a.corners[i].y!=b.corners[i].y)
+			return false;
+	for(int i=0;i<3;i++)
+		if (a.path[i].x!=b.path[i].x || a.path[i].y!=b.path[i].y)
+			return false;
+	return a.v==b.v && a.pair==b.pair;
+}
+
+template<typename T>
+static void load(T &t, const std::string &s) {
+	std::istringstream is(s);
+	xmlserial::Load(t,is);
+}
+
+int main() {
+	Grid g;
+	fill(g,3);
+	for(int bulk=0;bulk<2;bulk++) {
+		std::ostringstream os;
+		if (bulk) os << xmlserial::bulkarrays;
+		xmlserial::Save(g,os);
+		Grid h;
+		fill(h,8);
+		load(h,os.str());
+		CHECK(same(g,h));
+		if (bulk) {
+			// (arrays of arrays are one run, with no inner tags)
+			CHECK(os.str().find("<carray enc=\"b64\" name=\"m\">")
+				!=std::string::npos);
+			CHECK(os.str().find("<carray.double")==std::string::npos);
+			CHECK(os.str().find("<array.float")==std::string::npos);
+		}
+	}
+
+	// the wrong number of elements
+	Pt ps[2];
+	std::ostringstream os;
+	Pt three[3] = { {1,2}, {3,4}, {5,6} };
+	xmlserial::Save(three,os);
+	std::string s = os.str();
+	CHECK_THROWS(load(ps,s),xmlserial::streamexception);
+	std::array<Pt,4> four;
+	std::string sa = s;
+	sa.replace(sa.find("carray"),6,"array");
+	sa.replace(sa.rfind("carray"),6,"array");
+	CHECK_THROWS(load(four,sa),xmlserial::streamexception);
+	std::array<Pt,3> ok;
+	load(ok,sa);
+	CHECK(ok[2].x==5 && ok[2].y==6);
+	double d3[3];
+	CHECK_THROWS(load(d3,"<carray.double>1 2 <\\carray.double>"),
+		xmlserial::streamexception);
+	CHECK_THROWS(load(d3,"<carray.double>1 2 3 4 <\\carray.double>"),
+		xmlserial::streamexception);
+	load(d3,"<carray.double>1 2 3 <\\carray.double>");
+	CHECK(d3[0]==1 && d3[2]==3);
+
+	return TestResult();
+}
@@ -0,0 +1,105 @@
+/* Test of the bulk (base64) form of arrays of numbers
+ * (xmlserial_bulk.h):  the exact bytes written, round trips of every
+ * number type (with their extreme values, and doubles bit for bit) in
+ * vectors and deques of lengths around the writer's block, switching back
+ * with textarrays, and malformed data.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/base64.cpp -o base64
+ */
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <sstream>
+#include <limits>
+#include <cstring>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_deque.h"
+#include "check.h"
+
+template<typename C>
+static std::string save(const C &c, bool bulk) {
+	std::ostringstream os;
+	if (bulk) os << xmlserial::bulkarrays;
+	xmlserial::Save(c,os);
+	return os.str();
+}
+
+template<typename C>
+static C load(const std::string &s) {
+	std::istringstream is(s);
+	C c;
+	xmlserial::Load(c,is);
+	return c;
+}
+
+// round trips of vectors and deques of T around the block size
+template<typename T>
+static void types() {
+	const std::size_t block = 3*8*256/sizeof(T);
+	const std::size_t ns[] = { 0, 1, 2, 3, block-1, block, block+1,
+		3*block+2 };
+	for(std::size_t k=0;k<sizeof(ns)/sizeof(ns[0]);k++) {
+		std::vector<T> v(ns[k]);
+		for(std::size_t i=0;i<v.size();i++)
+			v[i] = i%3==0 ? std::numeric_limits<T>::max()
+				: i%3==1 ? std::numeric_limits<T>::min() : T(i);
+		std::string s = save(v,true);
+		CHECK(s.find("enc=\"b64\"")!=std::string::npos);
+		CHECK(load<std::vector<T> >(s)==v);
+		std::deque<T> d(v.begin(),v.end());
+		CHECK(load<std::deque<T> >(save(d,true))==d);
+	}
+}
+
+int main() {
+	// little-endian bytes, in base64
+	std::vector<int> v;
+	v.push_back(1);
+	v.push_back(2);
+	CHECK(save(v,true).find(">AQAAAAIAAAA=<")!=std::string::npos);
+	v.push_back(-1);
+	CHECK(save(v,true).find(">AQAAAAIAAAD/////<")!=std::string::npos);
+
+	types<char>();
+	types<signed char>();
+	types<unsigned char>();
+	types<short>();
+	types<unsigned short>();
+	types<int>();
+	types<unsigned int>();
+	types<long>();
+	types<unsigned long>();
+	types<float>();
+	types<double>();
+
+	// doubles are kept bit for bit (NaNs, -0, subnormals)
+	std::vector<double> d;
+	d.push_back(std::numeric_limits<double>::quiet_NaN());
+	d.push_back(-0.0);
+	d.push_back(std::numeric_limits<double>::infinity());
+	d.push_back(std::numeric_limits<double>::denorm_min());
+	d.push_back(0.1);
+	std::vector<double> d2 = load<std::vector<double> >(save(d,true));
+	CHECK(d2.size()==d.size()
+		&& std::memcmp(&d[0],&d2[0],d.size()*sizeof(double))==0);
+
+	// textarrays switches back
+	std::ostringstream os;
+	os << xmlserial::bulkarrays << xmlserial::textarrays;
+	xmlserial::Save(v,os);
+	CHECK(os.str().find("enc=")==std::string::npos);
+	CHECK(os.str().find(">1 2 -1 <")!=std::string::npos);
+
+	// malformed, short or unknown encodings
+	CHECK_THROWS(load<std::vector<int> >("<vector.int nelem=\"2\" enc=\"b64\">AQAAAAIAAA!=<\\vector.int>"),
+		xmlserial::streamexception);
+	CHECK_THROWS(load<std::vector<int> >("<vector.int nelem=\"3\" enc=\"b64\">AQAAAAIAAAA=<\\vector.int>"),
+		xmlserial::streamexception);
+	CHECK_THROWS(load<std::vector<int> >("<vector.int nelem=\"2\" enc=\"hex\">0100000002000000<\\vector.int>"),
+		xmlserial::streamexception);
+
+	return TestResult();
+}
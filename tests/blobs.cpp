@@ -0,0 +1,103 @@
+/* Test of string blobs (blobstrings):  strings of any bytes, of lengths
+ * around the short-string limit and the loader's block, round trip in
+ * base64; short strings stay text (but for those with a NUL); arrays of
+ * bytes take the bulk form; textstrings switches back; and a missing or
+ * wrong len is an error.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/blobs.cpp -o blobs
+ */
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_string.h"
+#include "check.h"
+
+struct Payload {
+	std::string name;
+	std::string data;
+	std::vector<char> raw;
+	XMLSERIALCLASS(Payload,,name,data,raw)
+};
+
+static std::string bytes(std::size_t n) {
+	std::string s(n,'\0');
+	for(std::size_t i=0;i<n;i++) s[i] = char(i*131+(i>>8));
+	return s;
+}
+
+template<typename T>
+static std::string save(const T &t) {
+	std::ostringstream os;
+	os << xmlserial::blobstrings;
+	xmlserial::Save(t,os);
+	return os.str();
+}
+
+template<typename T>
+static void load(T &t, const std::string &s) {
+	std::istringstream is(s);
+	xmlserial::Load(t,is);
+}
+
+int main() {
+	const std::size_t block = 64*3*8*256;
+	const std::size_t ns[] = { 0, 1, 19, 20, 21, 255, 256, 257, 4096,
+		block-1, block, block+1, 2*block+5 };
+	for(std::size_t k=0;k<sizeof(ns)/sizeof(ns[0]);k++) {
+		Payload p, q;
+		p.name = "blob";
+		p.data = bytes(ns[k]);
+		std::string r = bytes(ns[k]%300);
+		p.raw.assign(r.begin(),r.end());
+		q.data = "old";
+		std::string s = save(p);
+		load(q,s);
+		CHECK(q.name==p.name);
+		CHECK(q.data==p.data);
+		CHECK(q.raw==p.raw);
+		// (the short name stays text)
+		CHECK(s.find("value=\"blob\"")!=std::string::npos);
+		// (and so do strings under 20 bytes, unless they hold a NUL)
+		CHECK((s.find("enc=\"b64\" len=\""+std::to_string(ns[k])+"\"")
+			!=std::string::npos)==(ns[k]>0));
+	}
+
+	// a NUL in a short string, without blobstrings
+	std::string nul("a\0b",3), nul2;
+	std::ostringstream ns0;
+	xmlserial::Save(nul,ns0);
+	load(nul2,ns0.str());
+	CHECK(nul2==nul);
+
+	// textstrings switches back
+	std::string text = "a text string of some length";
+	std::ostringstream os;
+	os << xmlserial::blobstrings << xmlserial::textstrings;
+	xmlserial::Save(text,os);
+	CHECK(os.str().find(text)!=std::string::npos);
+	CHECK(os.str().find("enc=")==std::string::npos);
+	std::string back;
+	load(back,save(text));
+	CHECK(back==text);
+
+	// len missing, or more than the data
+	std::string good = save(text);
+	CHECK(good.find("len=\"28\"")!=std::string::npos);
+	std::string nolen = good, longer = good, shorter = good;
+	nolen.replace(nolen.find("len=\"28\""),8,"");
+	longer.replace(longer.find("len=\"28\""),8,"len=\"29\"");
+	shorter.replace(shorter.find("len=\"28\""),8,"len=\"27\"");
+	CHECK_THROWS(load(back,nolen),xmlserial::streamexception);
+	CHECK_THROWS(load(back,longer),xmlserial::streamexception);
+	CHECK_THROWS(load(back,shorter),xmlserial::streamexception);
+	// a huge len is not trusted
+	std::string huge = good;
+	huge.replace(huge.find("len=\"28\""),8,"len=\"4000000000\"");
+	CHECK_THROWS(load(back,huge),xmlserial::streamexception);
+
+	return TestResult();
+}
@@ -0,0 +1,129 @@
+/* Test of borrowed strings (xmlserial_borrowed.h):  loaded from a
+ * membuffer, long strings without escapes point into its memory, and the
+ * rest (short, escaped, and archive string references) are decoded into
+ * its arena; all have the values saved; and loading from other streams
+ * throws.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/borrowed.cpp -o borrowed
+ * (with -std=c++17, std::string_view members are tested too).
+ */
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_string.h"
+#include "xmlserial_borrowed.h"
+#include "xmlserial_archive.h"
+#include "check.h"
+
+struct Doc {
+	std::string title, body, quoted;
+	std::vector<std::string> words;
+	XMLSERIALCLASS(Doc,,title,body,quoted,words)
+};
+
+struct View {
+	xmlserial::borrowed_string title, body, quoted;
+	std::vector<xmlserial::borrowed_string> words;
+	XMLSERIALCLASS(View,,title,body,quoted,words)
+};
+
+#if __cplusplus >= 201703L
+struct SView {
+	std::string_view title, body, quoted;
+	std::vector<std::string_view> words;
+	XMLSERIALCLASS(SView,,title,body,quoted,words)
+};
+#endif
+
+// s with the tags of class a renamed to b
+static std::string retag(std::string s, const std::string &a,
+		const std::string &b) {
+	s.replace(s.find("<"+a+">"),a.length()+2,"<"+b+">");
+	s.replace(s.find("<\\"+a+">"),a.length()+3,"<\\"+b+">");
+	return s;
+}
+
+static bool inside(const char *p, const std::string &buf) {
+	return p>=buf.data() && p<=buf.data()+buf.size();
+}
+
+int main() {
+	Doc d;
+	d.title = "short";
+	d.body = std::string(5000,'b')+" plain text, no escapes";
+	d.quoted = "a \"quoted\" <string> with a \\ and a newline\n";
+	d.words.push_back("one");
+	d.words.push_back(std::string(100,'w'));
+	d.words.push_back(std::string(100,'w'));
+	d.words.push_back("");
+
+	std::ostringstream os;
+	xmlserial::Save(d,os);
+	const std::string buf = retag(os.str(),"Doc","View");
+	{
+		xmlserial::membuffer mb(buf.data(),buf.size());
+		std::istream in(&mb);
+		View v;
+		xmlserial::Load(v,in);
+		CHECK(v.title.str()==d.title);
+		CHECK(v.body.str()==d.body);
+		CHECK(v.quoted.str()==d.quoted);
+		CHECK(v.words.size()==d.words.size());
+		for(std::size_t i=0;i<v.words.size() && i<d.words.size();i++)
+			CHECK(v.words[i].str()==d.words[i]);
+		// (the long plain strings are not copied; the rest are)
+		CHECK(inside(v.body.data(),buf));
+		CHECK(inside(v.words[1].data(),buf));
+		CHECK(!inside(v.title.data(),buf));
+		CHECK(!inside(v.quoted.data(),buf));
+		// (tellg works, for stats and profiles)
+		CHECK(in.tellg()==std::streampos(buf.rfind('>')+1));
+
+		// saved, a borrowed string is a std::string
+		std::ostringstream os2;
+		xmlserial::Save(v,os2);
+		CHECK(os2.str()==buf);
+	}
+
+	// through an archive with a string table (references in the arena)
+	std::ostringstream aos;
+	{
+		xmlserial::archive a(aos);
+		a.strtable(20);
+		xmlserial::Save(d,a);
+	}
+	const std::string abuf = retag(aos.str(),"Doc","View");
+	CHECK(abuf.find("sref=")!=std::string::npos);
+	{
+		xmlserial::membuffer mb(abuf.data(),abuf.size());
+		std::istream in(&mb);
+		xmlserial::archive a(in);
+		View v;
+		xmlserial::Load(v,a);
+		CHECK(v.words.size()==4 && v.words[2].str()==d.words[2]);
+		CHECK(v.body.str()==d.body);
+	}
+
+#if __cplusplus >= 201703L
+	{
+		const std::string sbuf = retag(buf,"View","SView");
+		xmlserial::membuffer mb(sbuf.data(),sbuf.size());
+		std::istream in(&mb);
+		SView v;
+		xmlserial::Load(v,in);
+		CHECK(v.body==d.body && v.quoted==d.quoted && v.title==d.title);
+		CHECK(inside(v.body.data(),sbuf));
+	}
+#endif
+
+	// not from a membuffer
+	std::istringstream is(buf);
+	View v;
+	CHECK_THROWS(xmlserial::Load(v,is),xmlserial::streamexception);
+
+	return TestResult();
+}
@@ -0,0 +1,99 @@
+/* Test of arrays of numbers (xmlserial_bulk.h):  vectors, std::arrays and
+ * C arrays round trip both as text and in the bulk (base64) form, many
+ * small text arrays load one after another, and a large text array with
+ * long numbers crosses the reader's buffer boundaries intact.  Arrays of
+ * arbitrary bytes take the bulk form with blobstrings.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/bulk.cpp -o bulk
+ */
+
+#include <string>
+#include <vector>
+#include <array>
+#include <sstream>
+#include <cstring>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_array.h"
+#include "xmlserial_carray.h"
+#include "xmlserial_string.h"
+#include "check.h"
+
+struct Item {
+	std::array<double,3> pos;
+	std::vector<int> tags;
+	float grid[2][3];
+	XMLSERIALCLASS(Item,,pos,tags,grid)
+};
+
+struct Data {
+	std::vector<Item> items;
+	std::vector<double> big;
+	std::vector<unsigned char> bytes;
+	XMLSERIALCLASS(Data,,items,big,bytes)
+};
+
+static bool same(const Data &a, const Data &b) {
+	if (a.items.size()!=b.items.size() || a.big!=b.big || a.bytes!=b.bytes)
+		return false;
+	for(std::size_t i=0;i<a.items.size();i++)
+		if (a.items[i].pos!=b.items[i].pos || a.items[i].tags!=b.items[i].tags
+				|| std::memcmp(a.items[i].grid,b.items[i].grid,
+					sizeof(a.items[i].grid)))
+			return false;
+	return true;
+}
+
+static Data roundtrip(const Data &d, bool bulk) {
+	std::ostringstream os;
+	if (bulk) os << xmlserial::bulkarrays;
+	xmlserial::Save(d,os);
+	CHECK((os.str().find("enc=\"b64\"")!=std::string::npos)==bulk);
+	std::istringstream is(os.str());
+	Data r;
+	xmlserial::Load(r,is);
+	return r;
+}
+
+int main() {
+	Data d;
+	for(int i=0;i<2000;i++) {
+		Item it;
+		for(int j=0;j<3;j++) it.pos[j] = i*0.1+j;
+		for(int j=0;j<i%5;j++) it.tags.push_back(i-j*1000);
+		for(int j=0;j<6;j++) it.grid[j/3][j%3] = float(i)/(j+1);
+		d.items.push_back(it);
+	}
+	// long numbers (17 digits and an exponent), so that many straddle
+	// the reader's blocks
+	for(int i=0;i<200000;i++) d.big.push_back(1.0/(i+3)*1e-200);
+	// (bytes are written as characters in the text form)
+	for(int i=0;i<1000;i++) d.bytes.push_back((unsigned char)('a'+i%26));
+
+	CHECK(same(d,roundtrip(d,false)));
+	CHECK(same(d,roundtrip(d,true)));
+
+	// empty arrays
+	Data e;
+	e.items.resize(1);
+	CHECK(same(e,roundtrip(e,false)));
+	CHECK(same(e,roundtrip(e,true)));
+
+	// any bytes, with blobstrings
+	std::vector<unsigned char> raw, raw2;
+	for(int i=0;i<1000;i++) raw.push_back((unsigned char)(i*7));
+	std::ostringstream os;
+	os << xmlserial::blobstrings;
+	xmlserial::Save(raw,os);
+	std::istringstream is(os.str());
+	xmlserial::Load(raw2,is);
+	CHECK(raw2==raw);
+
+	// a bad number is an error, not a zero
+	std::istringstream bad("<vector.double nelem=\"3\">1 2x 3 <\\vector.double>");
+	std::vector<double> v;
+	CHECK_THROWS(xmlserial::Load(v,bad),xmlserial::streamexception);
+
+	return TestResult();
+}
@@ -0,0 +1,44 @@
+/* CHECK(cond) for the programs in tests/:  reports a failed condition
+ * (with its file and line) and counts it; TestResult() prints "ok" and
+ * returns 0 if none failed, or prints the number of failures and returns
+ * 1 (for main to return).
+ */
+
+#ifndef XMLSERIAL_TESTS_CHECK_H
+#define XMLSERIAL_TESTS_CHECK_H
+
+#include <iostream>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			std::cerr << __FILE__ << ":" << __LINE__ << ": failed: " \
+				<< #cond << std::endl; \
+			failures++; \
+		} \
+	} while(0)
+
+// CHECK that stmt throws an exception of type E
+#define CHECK_THROWS(stmt,E) \
+	do { \
+		bool thrown = false; \
+		try { stmt; } catch(E &) { thrown = true; } \
+		if (!thrown) { \
+			std::cerr << __FILE__ << ":" << __LINE__ \
+				<< ": failed: no exception from " << #stmt << std::endl; \
+			failures++; \
+		} \
+	} while(0)
+
+static inline int TestResult() {
+	if (failures) {
+		std::cerr << failures << " checks failed" << std::endl;
+		return 1;
+	}
+	std::cout << "ok" << std::endl;
+	return 0;
+}
+
+#endif
@@ -0,0 +1,111 @@
+/* Test of delta saves (xmlserial_delta.h):  a series of saves writes the
+ * whole object, then only the members changed (inside member classes and
+ * base classes too), and loading the series in order rebuilds each
+ * state; loading out of order is an error; presave runs once a save.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/delta.cpp -o delta
+ */
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_string.h"
+#include "xmlserial_delta.h"
+#include "check.h"
+
+static int presaves = 0, postloads = 0;
+
+struct Limits {
+	int lo, hi;
+	XMLSERIALCLASS(Limits,,lo,hi)
+};
+
+struct Common {
+	std::string owner;
+	XMLSERIALCLASS(Common,,owner)
+};
+
+struct Config : Common {
+	std::string name;
+	Limits limits;
+	std::vector<double> weights;
+	void xmlserial_presave() const { presaves++; }
+	void xmlserial_postload() { postloads++; }
+	XMLSERIALCLASS(Config,Common,name,limits,weights)
+};
+
+static bool same(const Config &a, const Config &b) {
+	return a.owner==b.owner && a.name==b.name && a.limits.lo==b.limits.lo
+		&& a.limits.hi==b.limits.hi && a.weights==b.weights;
+}
+
+int main() {
+	Config c;
+	c.owner = "me";
+	c.name = "first";
+	c.limits.lo = 0;
+	c.limits.hi = 10;
+	c.weights.assign(100,0.5);
+
+	xmlserial::deltatracker out;
+	std::vector<std::string> saves;
+	std::vector<Config> states;
+	for(int step=0;step<6;step++) {
+		if (step==1) c.limits.hi = 11;
+		if (step==2) c.weights[50] = 2;
+		if (step==3) c.owner = "you";
+		// (step 4 changes nothing)
+		if (step==5) out.reset();
+		presaves = 0;
+		std::ostringstream os;
+		xmlserial::SaveDelta(c,os,out);
+		CHECK(presaves==1);
+		saves.push_back(os.str());
+		states.push_back(c);
+	}
+	CHECK(out.sequence()==6);
+	CHECK(saves[0].find("first")!=std::string::npos);
+	CHECK(saves[0].find("delta=")==std::string::npos);
+	CHECK(saves[1].find("delta=\"1\"")!=std::string::npos);
+	CHECK(saves[1].find("base=\"1\"")!=std::string::npos);
+	// only what changed (and the classes holding it)
+	CHECK(saves[1].find("name=\"hi\"")!=std::string::npos);
+	CHECK(saves[1].find("name=\"lo\"")==std::string::npos);
+	CHECK(saves[1].find("first")==std::string::npos);
+	CHECK(saves[1].find("0.5")==std::string::npos);
+	CHECK(saves[2].find("0.5")!=std::string::npos);
+	CHECK(saves[2].find("name=\"hi\"")==std::string::npos);
+	CHECK(saves[3].find("you")!=std::string::npos);
+	CHECK(saves[3].find("name=\"limits\"")==std::string::npos);
+	CHECK(saves[4].find("name=")==std::string::npos);
+	CHECK(saves[5].find("delta=")==std::string::npos);
+	CHECK(saves[5].find("first")!=std::string::npos);
+	CHECK(saves[1].length()<saves[0].length()/4);
+
+	// loading in order
+	xmlserial::deltatracker in;
+	Config d;
+	postloads = 0;
+	for(std::size_t i=0;i<saves.size();i++) {
+		std::istringstream is(saves[i]);
+		xmlserial::LoadDelta(d,is,in);
+		CHECK(same(d,states[i]));
+	}
+	CHECK(postloads==int(saves.size()));
+	CHECK(in.sequence()==6);
+
+	// a delta that skips one, or with no base loaded
+	xmlserial::deltatracker in2;
+	Config e;
+	std::istringstream first(saves[0]), third(saves[2]);
+	xmlserial::LoadDelta(e,first,in2);
+	CHECK_THROWS(xmlserial::LoadDelta(e,third,in2),xmlserial::streamexception);
+	xmlserial::deltatracker in3;
+	std::istringstream second(saves[1]);
+	CHECK_THROWS(xmlserial::LoadDelta(e,second,in3),xmlserial::streamexception);
+
+	return TestResult();
+}
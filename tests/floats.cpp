@@ -0,0 +1,64 @@
+/* Test of how floats and doubles are written:  with the fewest digits
+ * that read back exactly (subnormals too), and exactly either way.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/floats.cpp -o floats
+ * (with -std=c++17, the library uses to_chars, if it has it, instead of
+ * sprintf).
+ */
+
+#include <string>
+#include <sstream>
+#include <cstdlib>
+#include <limits>
+#include <cmath>
+#include "xmlserial.h"
+#include "check.h"
+
+template<typename T>
+static std::string text(T t) {
+	std::ostringstream os;
+	xmlserial::Save(t,os);
+	std::string s = os.str();
+	std::string::size_type b = s.find("value=\"")+7;
+	return s.substr(b,s.find('"',b)-b);
+}
+
+// t saved and loaded back
+template<typename T>
+static T back(T t) {
+	std::ostringstream os;
+	xmlserial::Save(t,os);
+	std::istringstream is(os.str());
+	T ret;
+	xmlserial::Load(ret,is);
+	return ret;
+}
+
+int main() {
+	CHECK(text(0.1)=="0.1");
+	CHECK(text(1.5)=="1.5");
+	CHECK(text(0.1f)=="0.1");
+	CHECK(text(1e300)=="1e+300");
+	CHECK(text(1.0/3)=="0.3333333333333333");
+	// subnormals
+	CHECK(text(1e-320)=="1e-320");
+	CHECK(text(std::numeric_limits<double>::denorm_min())=="5e-324");
+	CHECK(text(-1e-320)=="-1e-320");
+	CHECK(text(1e-45f)=="1e-45");
+	CHECK(text(std::numeric_limits<double>::min())
+		=="2.2250738585072014e-308");
+
+	// everything reads back
+	srand(3);
+	for(int i=0;i<20000;i++) {
+		double d = (rand()/(RAND_MAX+1.0)-0.5)
+			*std::pow(10.0,rand()%600-300);
+		if (i%4==0) d *= 1e-20; // (some subnormal)
+		CHECK(back(d)==d);
+		float f = (float)d;
+		if (std::fabs(d)<1e38) CHECK(back(f)==f);
+	}
+
+	return TestResult();
+}
@@ -0,0 +1,164 @@
+/* Test of Hash and Equal (xmlserial_hash.h):  clones are equal and hash
+ * the same; changed values, sharing and subclasses count; unordered
+ * containers (with pointer keys too) do not depend on their order; and a
+ * polymorphic class with a forward_list member still builds and loads.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/hash.cpp -o hash
+ * (and with -DXMLSERIAL_STRUCTURAL, for the virtual methods).
+ */
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <forward_list>
+#include <unordered_map>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_string.h"
+#include "xmlserial_forward_list.h"
+#include "xmlserial_unordered_map.h"
+#include "check.h"
+
+struct Shape {
+	int id;
+	std::string label;
+	Shape *next;
+	Shape() : id(0), next(0) {}
+	virtual ~Shape() {}
+	XMLSERIALCLASS_P(Shape,,id,label,next)
+};
+
+struct Circle : Shape {
+	double r;
+	Circle() : r(0) {}
+	XMLSERIALCLASS_P(Circle,Shape,r)
+};
+
+struct Square : Shape {
+	double r;
+	Square() : r(0) {}
+	XMLSERIALCLASS_P(Square,Shape,r)
+};
+
+ENSURECLASS(Shape) ENSURECLASS(Circle) ENSURECLASS(Square)
+
+struct Scene {
+	std::vector<Shape *> shapes;
+	std::unordered_map<std::string,int> counts;
+	XMLSERIALCLASS(Scene,,shapes,counts)
+};
+
+struct Key {
+	int a;
+	std::string s;
+	XMLSERIALCLASS(Key,,a,s)
+};
+
+typedef std::unordered_map<Key *,int> keymap;
+
+// (forward_list has no size, which Hash must not need)
+struct Track {
+	int id;
+	std::forward_list<int> points;
+	Track() : id(0) {}
+	virtual ~Track() {}
+	XMLSERIALCLASS_P(Track,,id,points)
+};
+
+ENSURECLASS(Track)
+
+int main() {
+	Scene a;
+	Circle *c = new Circle;
+	c->id = 1;
+	c->r = 2;
+	c->next = c;
+	Shape *s = new Shape;
+	s->id = 2;
+	s->next = c;
+	a.shapes.push_back(c);
+	a.shapes.push_back(c);
+	a.shapes.push_back(s);
+	for(int i=0;i<100;i++) a.counts[std::to_string(i)] = i;
+
+	Scene b = xmlserial::Clone(a);
+	CHECK(xmlserial::Equal(a,b));
+	CHECK(xmlserial::Hash(a)==xmlserial::Hash(b));
+
+	// the order of an unordered container does not count
+	Scene d = xmlserial::Clone(a);
+	std::unordered_map<std::string,int> u;
+	for(int i=99;i>=0;i--) u[std::to_string(i)] = i;
+	u.rehash(1000);
+	d.counts = u;
+	CHECK(xmlserial::Equal(a,d));
+	CHECK(xmlserial::Hash(a)==xmlserial::Hash(d));
+	d.counts["5"] = 6;
+	CHECK(!xmlserial::Equal(a,d));
+	CHECK(xmlserial::Hash(a)!=xmlserial::Hash(d));
+
+	// values of subclasses count
+	Scene e = xmlserial::Clone(a);
+	static_cast<Circle *>(e.shapes[0])->r = 3;
+	CHECK(!xmlserial::Equal(a,e));
+	CHECK(xmlserial::Hash(a)!=xmlserial::Hash(e));
+
+	// sharing counts
+	Scene f = xmlserial::Clone(a);
+	f.shapes[1] = xmlserial::Clone(f.shapes[0]);
+	CHECK(!xmlserial::Equal(a,f));
+	CHECK(xmlserial::Hash(a)!=xmlserial::Hash(f));
+
+	// the subclass counts
+	Scene g = xmlserial::Clone(a);
+	Square *sq = new Square;
+	sq->id = 1;
+	sq->r = 2;
+	sq->next = sq;
+	g.shapes[0] = g.shapes[1] = g.shapes[2]->next = sq;
+	CHECK(!xmlserial::Equal(a,g));
+	CHECK(xmlserial::Hash(a)!=xmlserial::Hash(g));
+
+	// numbers by value, strings by bytes
+	int i3 = 3;
+	long l3 = 3;
+	CHECK(xmlserial::Hash(i3)==xmlserial::Hash(l3));
+	CHECK(xmlserial::Hash(std::string("abcdefghi"))
+		==xmlserial::Hash(std::string("abcdefghi")));
+	CHECK(xmlserial::Hash(std::string("abc"))
+		!=xmlserial::Hash(std::string("abd")));
+
+	// pointer keys compare by what they point to
+	keymap m;
+	for(int i=0;i<30;i++) {
+		Key *k = new Key;
+		k->a = i%7;
+		k->s = "k";
+		m[k] = i%2;
+	}
+	keymap n = xmlserial::Clone(m);
+	CHECK(xmlserial::Hash(m)==xmlserial::Hash(n));
+	CHECK(xmlserial::Equal(m,n));
+	n.begin()->second = 5;
+	CHECK(!xmlserial::Equal(m,n));
+
+	// forward_list
+	Track t;
+	t.id = 4;
+	t.points.push_front(2);
+	t.points.push_front(1);
+	std::ostringstream os;
+	xmlserial::Save(t,os);
+	std::istringstream is(os.str());
+	Track t2;
+	xmlserial::Load(t2,is);
+	CHECK(t2.points==t.points);
+	CHECK(xmlserial::Equal(t,t2));
+	CHECK(xmlserial::Hash(t)==xmlserial::Hash(t2));
+	t2.points.push_front(0);
+	CHECK(!xmlserial::Equal(t,t2));
+	CHECK(xmlserial::Hash(t)!=xmlserial::Hash(t2));
+
+	return TestResult();
+}
@@ -0,0 +1,92 @@
+/* Test of interned strings (xmlserial_interned.h):  equal values loaded
+ * share one string in the pool used (the stream's, an archive's, or the
+ * global one), they are saved as std::strings are, and threads can intern
+ * into one pool at once.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -pthread -I. tests/interned.cpp -o interned
+ */
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <thread>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_string.h"
+#include "xmlserial_interned.h"
+#include "xmlserial_archive.h"
+#include "check.h"
+
+struct Rec {
+	int id;
+	xmlserial::interned_string kind;
+	XMLSERIALCLASS(Rec,,id,kind)
+};
+
+struct Plain {
+	int id;
+	std::string kind;
+	XMLSERIALCLASS(Plain,,id,kind)
+};
+
+static const char *kinds[] = { "red", "green",
+	"a kind with a rather longer name" };
+
+int main() {
+	std::vector<Rec> recs(300);
+	for(std::size_t i=0;i<recs.size();i++) {
+		recs[i].id = int(i);
+		recs[i].kind = xmlserial::interned_string(kinds[i%3]);
+	}
+	std::ostringstream os;
+	xmlserial::Save(recs,os);
+
+	// into a pool of the stream's
+	xmlserial::stringpool pool;
+	std::istringstream is(os.str());
+	xmlserial::usepool(is,pool);
+	std::vector<Rec> back;
+	xmlserial::Load(back,is);
+	CHECK(back.size()==recs.size());
+	CHECK(pool.size()==3);
+	for(std::size_t i=0;i<back.size();i++) {
+		CHECK(back[i].kind==recs[i].kind);
+		CHECK(back[i].kind.c_str()==back[i%3].kind.c_str());
+	}
+	CHECK(back[0].kind!=back[1].kind);
+
+	// through an archive, into the global pool
+	std::size_t before = xmlserial::stringpool::global().size();
+	{
+		std::istringstream is2(os.str());
+		xmlserial::archive a(is2);
+		std::vector<Rec> back2;
+		xmlserial::Load(back2,a);
+		CHECK(back2[5].kind.c_str()==back2[2].kind.c_str());
+		CHECK(back2[5].kind.c_str()!=back[5].kind.c_str());
+	}
+	CHECK(xmlserial::stringpool::global().size()==before);
+
+	// saved as std::strings are
+	std::vector<Plain> plain;
+	std::string text = os.str();
+	for(std::string::size_type p;(p=text.find("Rec"))!=std::string::npos;)
+		text.replace(p,3,"Plain");
+	std::istringstream is3(text);
+	xmlserial::Load(plain,is3);
+	CHECK(plain.size()==recs.size() && plain[2].kind==kinds[2]);
+
+	// interning from several threads at once
+	xmlserial::stringpool shared;
+	std::vector<std::thread> ts;
+	for(int t=0;t<4;t++)
+		ts.push_back(std::thread([&shared,t]() {
+			for(int i=0;i<2000;i++)
+				shared.intern(std::to_string((i*7+t)%500));
+		}));
+	for(std::size_t t=0;t<ts.size();t++) ts[t].join();
+	CHECK(shared.size()==500);
+
+	return TestResult();
+}
@@ -0,0 +1,139 @@
+/* Test of lazy members (xmlserial_lazy.h):  a loaded lazy<T> is pending
+ * until used and then has the value saved; unchanged, it is saved as the
+ * text it was loaded from, and changed, from its value; loaded from a
+ * membuffer it points into its memory, and from other streams it keeps a
+ * copy; text that does not parse throws when parsed; and copies keep the
+ * text.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/lazy.cpp -o lazy
+ */
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_string.h"
+#include "xmlserial_lazy.h"
+#include "check.h"
+
+struct Data {
+	int id;
+	std::vector<double> big;
+	std::string note;
+	Data() : id(0) {}
+	XMLSERIALCLASS(Data,,id,big,note)
+};
+
+struct LazyData {
+	int id;
+	xmlserial::lazy<std::vector<double> > big;
+	xmlserial::lazy<std::string> note;
+	LazyData() : id(0) {}
+	XMLSERIALCLASS(LazyData,,id,big,note)
+};
+
+// s with the tags of class a renamed to b
+static std::string retag(std::string s, const std::string &a,
+		const std::string &b) {
+	s.replace(s.find("<"+a+">"),a.length()+2,"<"+b+">");
+	s.replace(s.find("<\\"+a+">"),a.length()+3,"<\\"+b+">");
+	return s;
+}
+
+static std::string tostring(const LazyData &l) {
+	std::ostringstream os;
+	xmlserial::Save(l,os);
+	return os.str();
+}
+
+int main() {
+	Data d;
+	d.id = 3;
+	for(int i=0;i<1000;i++) d.big.push_back(i*0.5);
+	d.note = "a note with <angle brackets> and \"quotes\"";
+	std::ostringstream os;
+	xmlserial::Save(d,os);
+	std::string buf = retag(os.str(),"Data","LazyData");
+
+	// from a stream that is not a membuffer:  a copy of the text
+	{
+		std::istringstream is(buf);
+		LazyData l;
+		xmlserial::Load(l,is);
+		CHECK(l.id==3);
+		CHECK(l.big.ispending() && l.big.isverbatim());
+		CHECK(l.note.ispending());
+		CHECK(tostring(l)==buf);
+		const LazyData &cl = l;
+		CHECK(cl.big.get()==d.big);
+		CHECK(!l.big.ispending() && l.big.isverbatim());
+		CHECK(*l.note==d.note);
+		CHECK(tostring(l)==buf);
+
+		// copies keep the text (and so are saved the same)
+		LazyData c(l), e;
+		e = l;
+		CHECK(tostring(c)==buf && tostring(e)==buf);
+		CHECK(c.big.isverbatim() && c.big->size()==1000);
+
+		// changed, the value is saved
+		l.big->push_back(7);
+		CHECK(!l.big.isverbatim());
+		d.big.push_back(7);
+		std::ostringstream os2;
+		xmlserial::Save(d,os2);
+		CHECK(tostring(l)==retag(os2.str(),"Data","LazyData"));
+		d.big.pop_back();
+		l.note = std::string("new");
+		CHECK(!l.note.isverbatim() && *l.note=="new");
+		CHECK(e.big.isverbatim() && tostring(e)==buf);
+	}
+
+	// from a membuffer:  points into its memory
+	{
+		std::string mbuf = buf;
+		xmlserial::membuffer mb(mbuf.data(),mbuf.size());
+		std::istream in(&mb);
+		LazyData l;
+		xmlserial::Load(l,in);
+		CHECK(l.big.ispending());
+		CHECK(tostring(l)==buf);
+		std::size_t p = mbuf.find("499.5");
+		CHECK(p!=std::string::npos);
+		mbuf[p] = '3';
+		const LazyData &cl = l;
+		CHECK(cl.big.get()[999]==399.5);
+		CHECK(tostring(l).find("399.5")!=std::string::npos);
+		// (a copy has its own text)
+		LazyData c(l);
+		mbuf[p] = '4';
+		CHECK(c.big.get()[999]==399.5);
+		CHECK(tostring(c).find("399.5")!=std::string::npos);
+	}
+
+	// text that does not parse throws when parsed (not when loaded)
+	{
+		std::string bad = buf;
+		bad.replace(bad.find("499.5"),5,"4x9.5");
+		std::istringstream is(bad);
+		LazyData l;
+		xmlserial::Load(l,is);
+		CHECK(l.big.ispending());
+		CHECK_THROWS(l.big.parse(),xmlserial::streamexception);
+		CHECK(*l.note==d.note);
+	}
+
+	// never loaded:  saved as a T
+	{
+		LazyData l;
+		l.id = 3;
+		l.big = d.big;
+		l.note = d.note;
+		CHECK(!l.big.ispending() && !l.big.isverbatim());
+		CHECK(tostring(l)==buf);
+	}
+
+	return TestResult();
+}
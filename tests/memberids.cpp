@@ -0,0 +1,125 @@
+/* Test of member ids (memberids):  members are written by position, or
+ * by the id fixed with XMLSERIAL_VAR_ID (so that reordering them keeps
+ * old streams loading), base classes and names mix with ids, the schema
+ * lists them, and unknown or repeated ids are errors.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/memberids.cpp -o memberids
+ */
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_string.h"
+#include "check.h"
+
+// the same class, before and after reordering its members
+struct Before {
+	int a;
+	std::string b;
+	std::vector<double> c;
+	XMLSERIAL_START(Before)
+		XMLSERIAL_VAR_ID(int,a,5)
+		XMLSERIAL_VAR_ID(std::string,b,2)
+		XMLSERIAL_VAR_ID(std::vector<double>,c,9)
+	XMLSERIAL_END
+};
+
+struct After {
+	std::vector<double> c;
+	int a;
+	std::string b;
+	XMLSERIAL_START(After)
+		XMLSERIAL_VAR_ID(std::vector<double>,c,9)
+		XMLSERIAL_VAR_ID(int,a,5)
+		XMLSERIAL_VAR_ID(std::string,b,2)
+	XMLSERIAL_END
+};
+
+struct Base {
+	int x, y;
+	XMLSERIALCLASS(Base,,x,y)
+};
+
+struct Derived : Base {
+	std::string name;
+	double w;
+	XMLSERIALCLASS(Derived,Base,name,w)
+};
+
+struct Twice {
+	int p, q;
+	XMLSERIAL_START(Twice)
+		XMLSERIAL_VAR_ID(int,p,1)
+		XMLSERIAL_VAR_ID(int,q,1)
+	XMLSERIAL_END
+};
+
+template<typename T>
+static std::string save(const T &t) {
+	std::ostringstream os;
+	os << xmlserial::memberids;
+	xmlserial::Save(t,os);
+	return os.str();
+}
+
+template<typename T>
+static void load(T &t, const std::string &s) {
+	std::istringstream is(s);
+	xmlserial::Load(t,is);
+}
+
+int main() {
+	Before b;
+	b.a = 3;
+	b.b = "bee";
+	b.c.push_back(1.5);
+	std::string s = save(b);
+	CHECK(s.find("mid=\"5\"")!=std::string::npos);
+	CHECK(s.find("mid=\"9\"")!=std::string::npos);
+	CHECK(s.find("name=")==std::string::npos);
+	s.replace(s.find("<Before>"),8,"<After>");
+	s.replace(s.find("<\\Before>"),9,"<\\After>");
+	After a;
+	load(a,s);
+	CHECK(a.a==3 && a.b=="bee" && a.c==b.c);
+
+	// by position, with a base class; and mixed with names
+	Derived d;
+	d.x = 1;
+	d.y = 2;
+	d.name = "dee";
+	d.w = 0.5;
+	std::string ds = save(d);
+	CHECK(ds.find("<string mid=\"1\" value=\"dee\" \\>")!=std::string::npos);
+	Derived d2;
+	load(d2,ds);
+	CHECK(d2.x==1 && d2.y==2 && d2.name=="dee" && d2.w==0.5);
+	std::ostringstream named;
+	named << xmlserial::memberids << xmlserial::membernames;
+	xmlserial::Save(d,named);
+	std::string mixed = named.str();
+	mixed.replace(mixed.find("name=\"w\""),8,"mid=\"2\"");
+	Derived d3;
+	load(d3,mixed);
+	CHECK(d3.x==1 && d3.y==2 && d3.name=="dee" && d3.w==0.5);
+
+	// the schema
+	std::ostringstream schema;
+	xmlserial::SaveSchema<Before>(schema);
+	CHECK(schema.str().find("class=\"Before\"")!=std::string::npos);
+	CHECK(schema.str().find("<member mid=\"2\" name=\"b\" type=\"string\" \\>")
+		!=std::string::npos);
+
+	// an unknown id, and two members with one id
+	std::string unknown = ds;
+	unknown.replace(unknown.find("mid=\"1\""),7,"mid=\"7\"");
+	CHECK_THROWS(load(d2,unknown),xmlserial::streamexception);
+	Twice t;
+	t.p = t.q = 0;
+	CHECK_THROWS(load(t,save(t)),xmlserial::streamexception);
+
+	return TestResult();
+}
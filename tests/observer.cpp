@@ -0,0 +1,136 @@
+/* Test of observers (xmlserial_observer.h):  saving and loading tell the
+ * observer of each member and container element entered and left, in
+ * nested pairs, with the stream's positions; and an archive can be given
+ * an observer of its own.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/observer.cpp -o observer
+ */
+
+#include <string>
+#include <vector>
+#include <sstream>
+
+// records what it is told (begin with +, end with -)
+struct Recorder {
+	struct event {
+		char what;
+		std::string type, member;
+		long long offset;
+	};
+	static std::vector<event> events;
+	static void on_begin(const char *t, const char *m, long long off) {
+		event e = { '+', t, m, off };
+		events.push_back(e);
+	}
+	static void on_end(const char *t, const char *m, long long off) {
+		event e = { '-', t, m, off };
+		events.push_back(e);
+	}
+};
+std::vector<Recorder::event> Recorder::events;
+
+#define XMLSERIAL_OBSERVER Recorder
+
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_string.h"
+#include "xmlserial_archive.h"
+#include "check.h"
+
+// counts what the archive is told
+struct Counter {
+	static int n;
+	static void on_begin(const char *, const char *, long long) { n++; }
+	static void on_end(const char *, const char *, long long) { }
+};
+int Counter::n = 0;
+
+namespace xmlserial {
+	template<>
+	struct ArchiveObserver<archive> {
+		typedef Counter type;
+	};
+}
+
+struct Item {
+	int id;
+	std::string name;
+	XMLSERIALCLASS(Item,,id,name)
+};
+
+struct Box {
+	std::vector<Item> items;
+	double weight;
+	XMLSERIALCLASS(Box,,items,weight)
+};
+
+// the events are in nested pairs with nondecreasing offsets (within
+// [0,len])
+static bool wellformed(long long len) {
+	std::vector<const Recorder::event *> open;
+	long long last = 0;
+	for(std::size_t i=0;i<Recorder::events.size();i++) {
+		const Recorder::event &e = Recorder::events[i];
+		if (e.offset<last || e.offset>len) return false;
+		last = e.offset;
+		if (e.what=='+') open.push_back(&e);
+		else {
+			if (open.empty() || open.back()->type!=e.type
+					|| open.back()->member!=e.member)
+				return false;
+			open.pop_back();
+		}
+	}
+	return open.empty();
+}
+
+static std::size_t count(char what, const char *type, const char *member) {
+	std::size_t n = 0;
+	for(std::size_t i=0;i<Recorder::events.size();i++)
+		if (Recorder::events[i].what==what
+				&& Recorder::events[i].type==type
+				&& Recorder::events[i].member==member)
+			n++;
+	return n;
+}
+
+int main() {
+	Box b;
+	b.items.resize(3);
+	for(int i=0;i<3;i++) {
+		b.items[i].id = i;
+		b.items[i].name = "item";
+	}
+	b.weight = 2.5;
+
+	std::ostringstream os;
+	xmlserial::Save(b,os);
+	const long long len = (long long)os.str().length();
+	CHECK(wellformed(len));
+	CHECK(count('+',"Box","items")==1 && count('+',"Box","weight")==1);
+	CHECK(count('+',"Item","id")==3 && count('-',"Item","name")==3);
+	CHECK(count('+',"vector","")==3);
+	CHECK(!Recorder::events.empty() && Recorder::events[0].offset>0);
+
+	Recorder::events.clear();
+	std::istringstream is(os.str());
+	Box c;
+	xmlserial::Load(c,is);
+	CHECK(c.items.size()==3 && c.weight==2.5);
+	CHECK(wellformed(len));
+	CHECK(count('+',"Item","name")==3 && count('-',"Box","weight")==1);
+	CHECK(count('-',"vector","")==3);
+
+	// an archive's own observer
+	Recorder::events.clear();
+	std::ostringstream aos;
+	{
+		xmlserial::archive a(aos);
+		xmlserial::Save(b,a);
+	}
+	CHECK(Recorder::events.empty());
+	CHECK(Counter::n==2+3*3);
+
+	return TestResult();
+}
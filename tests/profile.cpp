@@ -0,0 +1,107 @@
+/* Test of the profile (xmlserial_profile.h):  saving and loading count
+ * each class object and member once per use, with exclusive times no
+ * more than inclusive ones and the bytes each covers; trace(true) records
+ * events for chrometrace; clear() empties it all.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/profile.cpp -o profile
+ * (it defines XMLSERIAL_PROFILE itself).
+ */
+
+#define XMLSERIAL_PROFILE
+
+#include <string>
+#include <vector>
+#include <map>
+#include <sstream>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_string.h"
+#include "check.h"
+
+struct Inner {
+	double x;
+	XMLSERIALCLASS(Inner,,x)
+};
+
+struct Rec {
+	int a;
+	std::string s;
+	Inner in;
+	XMLSERIALCLASS(Rec,,a,s,in)
+};
+
+struct row {
+	double excl, incl;
+	unsigned long long calls, bytes;
+};
+
+// the report, by name ("save Rec.a")
+static std::map<std::string,row> report() {
+	std::ostringstream os;
+	xmlserial::Profile().report(os);
+	std::istringstream is(os.str());
+	std::string line;
+	std::getline(is,line); // (the heading)
+	std::map<std::string,row> ret;
+	while(std::getline(is,line)) {
+		std::istringstream ls(line);
+		row r;
+		std::string phase, name;
+		ls >> r.excl >> r.incl >> r.calls >> r.bytes >> phase >> name;
+		ret[phase+" "+name] = r;
+	}
+	return ret;
+}
+
+int main() {
+	std::vector<Rec> v(10);
+	for(int i=0;i<10;i++) {
+		v[i].a = i;
+		v[i].s = "a string of a record";
+		v[i].in.x = i*0.5;
+	}
+	xmlserial::Profile().clear();
+	xmlserial::Profile().trace(true);
+	std::ostringstream os;
+	xmlserial::Save(v,os);
+	std::istringstream is(os.str());
+	std::vector<Rec> w;
+	xmlserial::Load(w,is);
+	CHECK(w.size()==10 && w[9].in.x==4.5);
+
+	std::map<std::string,row> r = report();
+	const char *names[] = { "save Rec", "save Rec.a", "save Rec.s",
+		"save Rec.in", "save Inner.x", "load Rec", "load Rec.a",
+		"load Inner", "load Inner.x" };
+	for(std::size_t i=0;i<sizeof(names)/sizeof(names[0]);i++) {
+		CHECK(r.count(names[i])==1);
+		CHECK(r[names[i]].calls==10);
+		CHECK(r[names[i]].excl<=r[names[i]].incl);
+	}
+	// (a record's bytes cover its members')
+	CHECK(r["save Rec"].bytes>0);
+	CHECK(r["save Rec"].bytes>=r["save Rec.s"].bytes+r["save Rec.a"].bytes);
+	CHECK(r["load Rec"].bytes>=r["load Rec.s"].bytes+r["load Rec.in"].bytes);
+	CHECK(r["load Rec.s"].bytes>0);
+	CHECK(r["save Rec"].incl>=r["save Rec.in"].incl);
+
+	std::ostringstream trace;
+	xmlserial::Profile().chrometrace(trace);
+	std::string t = trace.str();
+	CHECK(t.compare(0,16,"{\"traceEvents\":[")==0);
+	CHECK(t.find("\"name\":\"load Inner.x\"")!=std::string::npos);
+	std::size_t events = 0;
+	for(std::string::size_type p=0;(p=t.find("\"ph\":\"X\"",p))
+			!=std::string::npos;p++)
+		events++;
+	std::size_t calls = 0;
+	for(std::map<std::string,row>::iterator i=r.begin();i!=r.end();++i)
+		calls += i->second.calls;
+	CHECK(events==calls);
+
+	xmlserial::Profile().clear();
+	CHECK(report().empty());
+
+	return TestResult();
+}
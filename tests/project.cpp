@@ -0,0 +1,176 @@
+/* Test of projection loads (xmlserial_project.h):  LoadOnly loads just the
+ * members named (through members, base classes and vectors of classes)
+ * and leaves the rest as they were; members missing from the input are
+ * not an error; preload and postload are not run; and, in an archive,
+ * skipping the first holder of a pointed-to object or of a string of the
+ * string table throws.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/project.cpp -o project
+ */
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_string.h"
+#include "xmlserial_archive.h"
+#include "xmlserial_project.h"
+#include "check.h"
+
+struct Header {
+	long timestamp;
+	std::string source;
+	Header() : timestamp(0) {}
+	XMLSERIALCLASS(Header,,timestamp,source)
+};
+
+struct Base {
+	int version;
+	Base() : version(0) {}
+	XMLSERIALCLASS(Base,,version)
+};
+
+struct Item {
+	int id;
+	std::vector<double> values;
+	Item() : id(0) {}
+	XMLSERIALCLASS(Item,,id,values)
+};
+
+static int loads = 0;
+
+struct Rec : Base {
+	Header header;
+	std::vector<Item> items;
+	std::string comment;
+	void xmlserial_preload() { loads++; }
+	void xmlserial_postload() { loads++; }
+	XMLSERIALCLASS(Rec,Base,header,items,comment)
+};
+
+// (Rec without items and comment)
+struct Small : Base {
+	Header header;
+	XMLSERIALCLASS(Small,Base,header)
+};
+
+struct Node {
+	int id;
+	Node() : id(0) {}
+	XMLSERIALCLASS(Node,,id)
+};
+
+struct Graph {
+	Node *first, *second;
+	std::string name, again;
+	Graph() : first(0), second(0) {}
+	XMLSERIALCLASS(Graph,,first,second,name,again)
+};
+
+int main() {
+	Rec r;
+	r.version = 2;
+	r.header.timestamp = 12345;
+	r.header.source = "sensor";
+	for(int i=0;i<5;i++) {
+		r.items.push_back(Item());
+		r.items.back().id = i+10;
+		r.items.back().values.assign(i,i*0.5);
+	}
+	r.comment = "a comment";
+	std::ostringstream os;
+	xmlserial::Save(r,os);
+	const std::string buf = os.str();
+
+	{
+		std::istringstream is(buf);
+		Rec l;
+		l.comment = "kept";
+		loads = 0;
+		xmlserial::LoadOnly(l,is,{"header.timestamp","items.id","Base"});
+		CHECK(loads==0);
+		CHECK(l.version==2);
+		CHECK(l.header.timestamp==12345);
+		CHECK(l.header.source.empty());
+		CHECK(l.items.size()==5);
+		for(std::size_t i=0;i<l.items.size();i++) {
+			CHECK(l.items[i].id==int(i)+10);
+			CHECK(l.items[i].values.empty());
+		}
+		CHECK(l.comment=="kept");
+		// (and all of the input is read)
+		CHECK(is.tellg()==std::streampos(buf.rfind('>')+1));
+	}
+
+	// a whole member, as a std::vector of paths
+	{
+		std::istringstream is(buf);
+		Rec l;
+		std::vector<std::string> paths;
+		paths.push_back("header");
+		paths.push_back("items");
+		xmlserial::LoadOnly(l,is,paths);
+		CHECK(l.version==0);
+		CHECK(l.header.source=="sensor" && l.header.timestamp==12345);
+		CHECK(l.items.size()==5 && l.items[4].values.size()==4);
+		CHECK(l.comment.empty());
+	}
+
+	// missing members
+	{
+		Small s;
+		s.version = 3;
+		s.header.source = "small";
+		std::ostringstream sos;
+		xmlserial::Save(s,sos);
+		std::string sbuf = sos.str();
+		sbuf.replace(sbuf.find("<Small>"),7,"<Rec>");
+		sbuf.replace(sbuf.find("<\\Small>"),8,"<\\Rec>");
+		std::istringstream is(sbuf);
+		Rec l;
+		l.comment = "kept";
+		xmlserial::LoadOnly(l,is,{"header.source","comment","items.id"});
+		CHECK(l.header.source=="small");
+		CHECK(l.comment=="kept" && l.items.empty());
+	}
+
+	// in an archive
+	Graph g;
+	g.first = g.second = new Node;
+	g.first->id = 4;
+	g.name = g.again = std::string(40,'n');
+	std::ostringstream aos;
+	{
+		xmlserial::archive a(aos);
+		a.strtable(20);
+		xmlserial::Save(g,a);
+	}
+	const std::string abuf = aos.str();
+	CHECK(abuf.find("sid=")!=std::string::npos);
+	{
+		std::istringstream is(abuf);
+		xmlserial::archive a(is);
+		Graph l;
+		xmlserial::LoadOnly(l,a,{"first","name"});
+		CHECK(l.first && l.first->id==4 && !l.second);
+		CHECK(l.name==g.name && l.again.empty());
+	}
+	{
+		std::istringstream is(abuf);
+		xmlserial::archive a(is);
+		Graph l;
+		CHECK_THROWS(xmlserial::LoadOnly(l,a,{"second"}),
+			xmlserial::streamexception);
+	}
+	{
+		std::istringstream is(abuf);
+		xmlserial::archive a(is);
+		Graph l;
+		CHECK_THROWS(xmlserial::LoadOnly(l,a,{"first","again"}),
+			xmlserial::streamexception);
+	}
+
+	return TestResult();
+}
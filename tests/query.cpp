@@ -0,0 +1,131 @@
+/* Test of path queries (xmlserial_query.h):  matches by tag, by name, by
+ * any tag and through any number of levels; the values and paths of
+ * matches (strings unescaped, elements holding others without a value);
+ * matches within matches; more than one top-level element; and errors in
+ * paths and in the input.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/query.cpp -o query
+ */
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_string.h"
+#include "xmlserial_query.h"
+#include "check.h"
+
+struct Holding {
+	std::string symbol;
+	double price;
+	int count;
+	Holding() : price(0), count(0) {}
+	XMLSERIALCLASS(Holding,,symbol,price,count)
+};
+
+struct Fund {
+	std::string name;
+	std::vector<Holding> holdings;
+	XMLSERIALCLASS(Fund,,name,holdings)
+};
+
+struct Portfolio {
+	std::string owner;
+	std::vector<Holding> holdings;
+	std::vector<Fund> funds;
+	XMLSERIALCLASS(Portfolio,,owner,holdings,funds)
+};
+
+struct collect {
+	std::vector<std::string> values, paths;
+	std::vector<bool> children;
+	void operator()(const xmlserial::querymatch &m) {
+		values.push_back(m.value);
+		std::string p;
+		for(std::size_t i=0;i<m.path.size();i++)
+			p += (i ? "/" : "")+m.path[i];
+		paths.push_back(p);
+		children.push_back(m.haschildren);
+	}
+};
+
+static collect run(const std::string &text, const std::string &path) {
+	std::istringstream is(text);
+	collect c;
+	std::size_t n = xmlserial::Query(is,xmlserial::pathquery(path),c);
+	CHECK(n==c.values.size());
+	return c;
+}
+
+static Holding holding(const std::string &s, double p, int n) {
+	Holding h;
+	h.symbol = s;
+	h.price = p;
+	h.count = n;
+	return h;
+}
+
+int main() {
+	Portfolio p;
+	p.owner = "a <quoted> \"owner\" & co";
+	p.holdings.push_back(holding("ABC",1.5,10));
+	p.holdings.push_back(holding("XYZ",2.25,20));
+	p.funds.push_back(Fund());
+	p.funds[0].name = "growth";
+	p.funds[0].holdings.push_back(holding("DEF",3.5,30));
+	std::ostringstream os;
+	xmlserial::Save(p,os);
+	const std::string buf = os.str();
+
+	collect c = run(buf,"Portfolio/@holdings/Holding/@price");
+	CHECK(c.values.size()==2 && c.values[0]=="1.5" && c.values[1]=="2.25");
+	CHECK(c.paths.size()==2 && c.paths[0]
+		=="Portfolio/vector@holdings/Holding/double@price");
+	CHECK(c.children.size()==2 && !c.children[0]);
+
+	// ** is any number of levels, and strings are unescaped
+	c = run(buf,"Portfolio/**/@price");
+	CHECK(c.values.size()==3 && c.values[2]=="3.5");
+	c = run(buf,"**/@symbol");
+	CHECK(c.values.size()==3 && c.values[0]=="ABC" && c.values[2]=="DEF");
+	c = run(buf,"Portfolio/@owner");
+	CHECK(c.values.size()==1 && c.values[0]==p.owner);
+	c = run(buf,"*/*/*/@count");
+	CHECK(c.values.size()==2 && c.values[1]=="20");
+
+	// an element holding others has no value, and matches within it are
+	// found too
+	c = run(buf,"**/Holding");
+	CHECK(c.values.size()==3);
+	CHECK(c.children.size()==3 && c.children[0] && c.values[0].empty());
+	c = run(buf,"**/@holdings/**/@symbol");
+	CHECK(c.values.size()==3);
+
+	// no match
+	c = run(buf,"Portfolio/@funds/Holding");
+	CHECK(c.values.empty());
+	c = run(buf,"Fund/@name");
+	CHECK(c.values.empty());
+
+	// more than one top-level element
+	c = run(buf+buf,"Portfolio/@funds/Fund/@name");
+	CHECK(c.values.size()==2 && c.values[1]=="growth");
+
+	// errors
+	CHECK_THROWS(xmlserial::pathquery("Portfolio/**"),
+		xmlserial::streamexception);
+	CHECK_THROWS(xmlserial::pathquery(""),xmlserial::streamexception);
+	collect e;
+	std::istringstream cut(buf.substr(0,buf.size()/2));
+	CHECK_THROWS(xmlserial::Query(cut,xmlserial::pathquery("**/@price"),e),
+		xmlserial::streamexception);
+	std::string wrong = buf;
+	wrong.replace(wrong.rfind("<\\Portfolio>"),12,"<\\Portfolia>");
+	std::istringstream ws(wrong);
+	CHECK_THROWS(xmlserial::Query(ws,xmlserial::pathquery("**/@owner"),e),
+		xmlserial::streamexception);
+
+	return TestResult();
+}
@@ -0,0 +1,108 @@
+/* Test of number members written from a cached tag prefix:  the text is
+ * exactly that of the general path, by name or by member id, and streams
+ * with a width or a locale that groups digits (which take the general
+ * path) still round trip.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/quicktags.cpp -o quicktags
+ */
+
+#include <string>
+#include <sstream>
+#include <locale>
+#include "xmlserial.h"
+#include "check.h"
+
+struct Nums {
+	int i;
+	unsigned u;
+	short s;
+	long l;
+	float f;
+	double d;
+	char c;
+	bool b;
+	XMLSERIALCLASS(Nums,,i,u,s,l,f,d,c,b)
+};
+
+// groups digits by threes with a comma, and uses , for the point
+struct Grouping : std::numpunct<char> {
+	char do_thousands_sep() const { return '\''; }
+	char do_decimal_point() const { return ','; }
+	std::string do_grouping() const { return "\3"; }
+};
+
+static bool same(const Nums &a, const Nums &b) {
+	return a.i==b.i && a.u==b.u && a.s==b.s && a.l==b.l && a.f==b.f
+		&& a.d==b.d && a.c==b.c && a.b==b.b;
+}
+
+int main() {
+	Nums n;
+	n.i = -1234567;
+	n.u = 4000000000u;
+	n.s = -3;
+	n.l = 1234567890L;
+	n.f = 0.25f;
+	n.d = 1.0/3;
+	n.c = 'x';
+	n.b = true;
+
+	std::ostringstream os;
+	xmlserial::Save(n,os);
+	CHECK(os.str()==
+		"<Nums>\n"
+		"\t<int name=\"i\" value=\"-1234567\" \\>\n"
+		"\t<u_int name=\"u\" value=\"4000000000\" \\>\n"
+		"\t<short name=\"s\" value=\"-3\" \\>\n"
+		"\t<long name=\"l\" value=\"1234567890\" \\>\n"
+		"\t<float name=\"f\" value=\"0.25\" \\>\n"
+		"\t<double name=\"d\" value=\"0.3333333333333333\" \\>\n"
+		"\t<char name=\"c\" value=\"x\" \\>\n"
+		"\t<bool name=\"b\" value=\"1\" \\>\n"
+		"<\\Nums>\n");
+
+	// (the prefix is made once, and other values still use it)
+	Nums m = n;
+	m.i = 7;
+	std::ostringstream os2;
+	xmlserial::Save(m,os2);
+	CHECK(os2.str().find("<int name=\"i\" value=\"7\" \\>")!=std::string::npos);
+
+	// by member id
+	std::ostringstream ms;
+	ms << xmlserial::memberids;
+	xmlserial::Save(n,ms);
+	CHECK(ms.str().find("<int mid=\"0\" value=\"-1234567\" \\>")
+		!=std::string::npos);
+	CHECK(ms.str().find("<bool mid=\"7\" value=\"1\" \\>")
+		!=std::string::npos);
+	Nums back;
+	std::istringstream mis(ms.str());
+	xmlserial::Load(back,mis);
+	CHECK(same(back,n));
+
+	// a width, and a locale that groups digits
+	std::ostringstream ws;
+	ws.width(12);
+	xmlserial::Save(n,ws);
+	std::istringstream wis(ws.str());
+	Nums wback;
+	xmlserial::Load(wback,wis);
+	CHECK(same(wback,n));
+
+	std::locale grouping(std::locale::classic(),new Grouping);
+	std::ostringstream gs;
+	gs.imbue(grouping);
+	// (with the locale, floats are written with <<, to its precision)
+	gs.precision(17);
+	xmlserial::Save(n,gs);
+	CHECK(gs.str().find("-1&apos;234&apos;567")!=std::string::npos);
+	std::istringstream gis(gs.str());
+	gis.imbue(grouping);
+	Nums gback;
+	xmlserial::Load(gback,gis);
+	CHECK(same(gback,n));
+
+	return TestResult();
+}
@@ -0,0 +1,169 @@
+/* Test of record streams (xmlserial_records.h):  records read in order
+ * and by number, with the index at the end of the stream, in a sidecar
+ * stream, or built from the records' lengths; split into ranges that
+ * cover every record; pointers shared within a record; and streams that
+ * start part way in.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/records.cpp -o records
+ */
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_string.h"
+#include "xmlserial_records.h"
+#include "check.h"
+
+struct Point {
+	int x;
+	Point() : x(0) {}
+	XMLSERIALCLASS(Point,,x)
+};
+
+struct Trade {
+	int id;
+	std::string symbol;
+	std::vector<double> prices;
+	Point *from, *to;
+	Trade() : id(0), from(0), to(0) {}
+	XMLSERIALCLASS(Trade,,id,symbol,prices,from,to)
+};
+
+static Trade trade(int i) {
+	Trade t;
+	t.id = i;
+	t.symbol = "sym" + std::to_string(i%7);
+	for(int j=0;j<i%13;j++) t.prices.push_back(i+j*0.5);
+	t.from = new Point;
+	t.from->x = i;
+	t.to = i%2 ? t.from : new Point;
+	return t;
+}
+
+static bool same(const Trade &a, const Trade &b) {
+	return a.id==b.id && a.symbol==b.symbol && a.prices==b.prices
+		&& a.from && b.from && a.from->x==b.from->x
+		&& (a.from==a.to)==(b.from==b.to);
+}
+
+// checks that r reads the n records of trade, by number and in order
+static void readall(xmlserial::recordreader &r, std::size_t n) {
+	CHECK(r.size()==n);
+	Trade t;
+	r.read(n/2,t);
+	CHECK(same(t,trade(int(n/2))));
+	CHECK(r.pos()==n/2+1);
+	r.read(n-1,t);
+	CHECK(same(t,trade(int(n-1))));
+	CHECK(!r.next(t));
+	r.read(0,t);
+	CHECK(same(t,trade(0)));
+	for(std::size_t i=1;i<n;i++) {
+		CHECK(r.next(t));
+		CHECK(same(t,trade(int(i))));
+	}
+	CHECK(!r.next(t));
+	CHECK_THROWS(r.read(n,t),xmlserial::streamexception);
+}
+
+int main() {
+	const std::size_t n = 200;
+
+	// with the index at the end
+	std::ostringstream os;
+	std::vector<std::streamoff> offs;
+	{
+		xmlserial::recordwriter w(os);
+		for(std::size_t i=0;i<n;i++) CHECK(w.append(trade(int(i)))==i);
+		CHECK(w.size()==n);
+		for(std::size_t i=0;i<n;i++) offs.push_back(w.offset(i));
+	}
+	const std::string buf = os.str();
+	CHECK(buf.find("<recordindexat offset=\"")!=std::string::npos);
+	{
+		std::istringstream is(buf);
+		xmlserial::recordreader r(is);
+		readall(r,n);
+		for(std::size_t i=0;i<n;i++) CHECK(r.offset(i)==offs[i]);
+	}
+	// in order, without seeking
+	{
+		std::istringstream is(buf);
+		xmlserial::recordreader r(is);
+		Trade t;
+		std::size_t i = 0;
+		while(r.next(t)) CHECK(same(t,trade(int(i++))));
+		CHECK(i==n);
+	}
+
+	// split into ranges, each read with its own stream and reader
+	{
+		std::istringstream is(buf);
+		xmlserial::recordreader r(is);
+		std::vector<std::pair<std::size_t,std::size_t> > parts = r.split(3);
+		CHECK(parts.size()==3);
+		std::size_t next = 0;
+		for(std::size_t p=0;p<parts.size();p++) {
+			CHECK(parts[p].first==next && parts[p].second>parts[p].first);
+			next = parts[p].second;
+			std::istringstream pis(buf);
+			xmlserial::recordreader pr(pis);
+			pr.seek(parts[p].first);
+			Trade t;
+			for(std::size_t i=parts[p].first;i<parts[p].second;i++) {
+				CHECK(pr.next(t));
+				CHECK(same(t,trade(int(i))));
+			}
+		}
+		CHECK(next==n);
+		CHECK(r.split(1000).size()==n);
+	}
+
+	// a sidecar index
+	std::ostringstream nos, side;
+	{
+		xmlserial::recordwriter w(nos,false);
+		for(std::size_t i=0;i<n;i++) w.append(trade(int(i)));
+		w.writeindex(side);
+	}
+	CHECK(nos.str().find("recordindex")==std::string::npos);
+	CHECK(nos.str()==buf.substr(0,nos.str().size()));
+	{
+		std::istringstream is(nos.str()), idx(side.str());
+		xmlserial::recordreader r(is);
+		r.readindex(idx);
+		readall(r,n);
+	}
+
+	// no index:  built from the records
+	{
+		std::istringstream is(nos.str());
+		xmlserial::recordreader r(is);
+		readall(r,n);
+		for(std::size_t i=0;i<n;i++) CHECK(r.offset(i)==offs[i]);
+		CHECK(r.split(4).size()==4);
+	}
+
+	// streams that start part way in (offsets count from the start of
+	// the records)
+	const std::string head = "a header line\n";
+	for(int withindex=0;withindex<2;withindex++) {
+		std::istringstream is(head+(withindex ? buf : nos.str()));
+		std::string line;
+		std::getline(is,line);
+		xmlserial::recordreader r(is);
+		readall(r,n);
+	}
+
+	// a bad index
+	{
+		std::istringstream is(nos.str()), idx("<record len=\"3\">");
+		xmlserial::recordreader r(is);
+		CHECK_THROWS(r.readindex(idx),xmlserial::streamexception);
+	}
+
+	return TestResult();
+}
@@ -0,0 +1,150 @@
+/* Test of sharded saving and loading: a vector of records pointing into
+ * a shared, polymorphic graph is saved to several shards (with member
+ * ids and bulk arrays) and loaded back in parallel, a few times over.
+ * Checks that what is loaded has the same values and the same sharing
+ * of objects as what was saved.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -pthread -I. tests/shards.cpp -o shards
+ * (adding -fsanitize=thread checks for data races too).
+ *
+ * Usage:  shards [N]   (N records, default 10000; exits with 1 on failure)
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include <cstdlib>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_string.h"
+#include "xmlserial_interned.h"
+#include "xmlserial_shard.h"
+#include "check.h"
+
+struct Node {
+	int id;
+	std::vector<double> weights;
+	std::vector<std::shared_ptr<Node> > out;
+	Node() : id(0) {}
+	virtual ~Node() {}
+	XMLSERIALCLASS_P(Node,,id,weights,out)
+};
+
+struct Leaf : Node {
+	std::vector<int> counts;
+	XMLSERIALCLASS_P(Leaf,Node,counts)
+};
+
+struct Record {
+	std::string name;
+	xmlserial::interned_string kind;
+	std::vector<float> series;
+	std::shared_ptr<Node> first, second;
+	XMLSERIALCLASS(Record,,name,kind,series,first,second)
+};
+
+// checks that b (loaded) matches a (saved), with the objects pointed to
+// corresponding one-to-one (in seen)
+static void compare(const Node *a, const Node *b,
+		std::map<const Node *,const Node *> &seen) {
+	CHECK((a==0)==(b==0));
+	if (!a || !b) return;
+	std::map<const Node *,const Node *>::iterator i = seen.find(a);
+	if (i!=seen.end()) {
+		CHECK(i->second==b);
+		return;
+	}
+	seen[a] = b;
+	CHECK(a->id==b->id);
+	CHECK(a->weights==b->weights);
+	const Leaf *la = dynamic_cast<const Leaf *>(a);
+	const Leaf *lb = dynamic_cast<const Leaf *>(b);
+	CHECK((la==0)==(lb==0));
+	if (la && lb) CHECK(la->counts==lb->counts);
+	CHECK(a->out.size()==b->out.size());
+	if (a->out.size()!=b->out.size()) return;
+	for(std::size_t j=0;j<a->out.size();j++)
+		compare(a->out[j].get(),b->out[j].get(),seen);
+}
+
+int main(int argc, char **argv) {
+	const int n = argc>1 ? atoi(argv[1]) : 10000;
+	const int nshards = 4, rounds = 5;
+	const char *kinds[] = { "alpha", "beta", "gamma" };
+
+	std::vector<std::shared_ptr<Node> > pool(n/4+1);
+	for(std::size_t i=0;i<pool.size();i++) {
+		if (i%3) pool[i] = std::make_shared<Node>();
+		else {
+			std::shared_ptr<Leaf> l = std::make_shared<Leaf>();
+			for(int j=0;j<5;j++) l->counts.push_back(int(i)*j);
+			pool[i] = l;
+		}
+		pool[i]->id = int(i);
+		for(int j=0;j<3;j++) pool[i]->weights.push_back(i*0.25+j);
+	}
+	srand(7);
+	for(std::size_t i=0;i<pool.size();i++)
+		for(int j=0;j<2;j++)
+			pool[i]->out.push_back(pool[rand()%pool.size()]);
+	// (loading interns the kinds in the global pool, from every shard)
+	xmlserial::stringpool own;
+	std::vector<Record> recs(n);
+	for(int i=0;i<n;i++) {
+		recs[i].name = "record" + std::to_string(i);
+		recs[i].kind = xmlserial::interned_string(
+			kinds[i%3] + std::to_string(i%50),own);
+		for(int j=0;j<i%20;j++) recs[i].series.push_back(i*0.5f+j);
+		recs[i].first = pool[rand()%pool.size()];
+		if (i%4) recs[i].second = pool[rand()%pool.size()];
+	}
+
+	for(int round=0;round<rounds;round++) {
+		std::vector<std::ostringstream> outs(nshards);
+		std::vector<std::ostream *> pouts;
+		for(int s=0;s<nshards;s++) {
+			outs[s] << xmlserial::memberids << xmlserial::bulkarrays;
+			pouts.push_back(&outs[s]);
+		}
+		xmlserial::SaveShards(recs,pouts);
+
+		std::vector<std::istringstream> ins;
+		std::vector<std::istream *> pins;
+		for(int s=0;s<nshards;s++) ins.emplace_back(outs[s].str());
+		for(int s=0;s<nshards;s++) pins.push_back(&ins[s]);
+		CHECK(outs[1].str().find("mid=")!=std::string::npos);
+		CHECK(outs[1].str().find("xshard=")!=std::string::npos);
+
+		std::vector<Record> loaded;
+		try {
+			xmlserial::LoadShards(loaded,pins);
+		} catch(std::exception &e) {
+			std::cerr << "round " << round << ": " << e.what() << std::endl;
+			return 1;
+		}
+
+		CHECK(loaded.size()==recs.size());
+		if (loaded.size()!=recs.size()) break;
+		std::map<const Node *,const Node *> seen;
+		for(int i=0;i<n;i++) {
+			CHECK(loaded[i].name==recs[i].name);
+			CHECK(loaded[i].kind==recs[i].kind);
+			CHECK(loaded[i].series==recs[i].series);
+			compare(recs[i].first.get(),loaded[i].first.get(),seen);
+			compare(recs[i].second.get(),loaded[i].second.get(),seen);
+		}
+		std::set<const Node *> targets;
+		for(std::map<const Node *,const Node *>::iterator i=seen.begin();
+				i!=seen.end();++i)
+			targets.insert(i->second);
+		CHECK(targets.size()==seen.size());
+		if (failures) break;
+	}
+
+	return TestResult();
+}
@@ -0,0 +1,91 @@
+/* Test of the counters of xmlserial_stats.h:  a load reads as many tags
+ * as the save wrote, whether the members are numbers (written with a
+ * quick tag), strings, containers, pointers or records, and by name or
+ * by member id.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/stats.cpp -o stats
+ * (it defines XMLSERIAL_STATS itself).
+ */
+
+#define XMLSERIAL_STATS
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_string.h"
+#include "xmlserial_records.h"
+#include "check.h"
+
+struct P {
+	int a;
+	double b;
+	XMLSERIALCLASS(P,,a,b)
+};
+
+struct Q {
+	std::string name;
+	std::vector<P> ps;
+	std::vector<double> xs;
+	P *first;
+	XMLSERIALCLASS(Q,,name,ps,xs,first)
+};
+
+// the tags written saving t and read loading it back (into u)
+template<typename T>
+static void count(const T &t, T &u, bool mids,
+		xmlserial::Stats::count &written, xmlserial::Stats::count &read) {
+	std::ostringstream os;
+	if (mids) os << xmlserial::memberids;
+	xmlserial::Stats s0 = xmlserial::GetStats();
+	xmlserial::Save(t,os);
+	xmlserial::Stats s1 = xmlserial::GetStats();
+	std::istringstream is(os.str());
+	xmlserial::Load(u,is);
+	xmlserial::Stats s2 = xmlserial::GetStats();
+	written = (s1-s0).tags_written;
+	read = (s2-s1).tags_read;
+}
+
+int main() {
+	xmlserial::Stats::count w, r;
+
+	P p, p2;
+	p.a = 1;
+	p.b = 2.5;
+	count(p,p2,false,w,r);
+	CHECK(w==4); // <P>, a, b, <\P>
+	CHECK(r==w);
+	count(p,p2,true,w,r);
+	CHECK(r==w);
+
+	Q q, q2;
+	q.name = "q";
+	q.ps.resize(3,p);
+	q.xs.resize(10,1.5);
+	q.first = &q.ps[0];
+	for(int mids=0;mids<2;mids++) {
+		count(q,q2,mids!=0,w,r);
+		CHECK(w>10);
+		CHECK(r==w);
+	}
+
+	// records (with their index)
+	std::stringstream ss;
+	xmlserial::Stats s0 = xmlserial::GetStats();
+	{
+		xmlserial::recordwriter rw(ss);
+		for(int i=0;i<5;i++) rw.append(p);
+	}
+	xmlserial::Stats s1 = xmlserial::GetStats();
+	xmlserial::recordreader rr(ss);
+	CHECK(rr.size()==5);
+	for(int i=0;i<5;i++) rr.read(i,p2);
+	xmlserial::Stats s2 = xmlserial::GetStats();
+	CHECK((s1-s0).tags_written==(s2-s1).tags_read);
+	CHECK(p2.a==1 && p2.b==2.5);
+
+	return TestResult();
+}
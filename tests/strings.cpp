@@ -0,0 +1,68 @@
+/* Test of strings written as text:  escaped characters anywhere
+ * (including across the blocks the loader reads), lengths around the
+ * short-string limit and the blocks, and a len that is wrong, missing or
+ * huge (it is only a hint for the loader).
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/strings.cpp -o strings
+ */
+
+#include <string>
+#include <sstream>
+#include "xmlserial.h"
+#include "xmlserial_string.h"
+#include "check.h"
+
+static std::string roundtrip(const std::string &s) {
+	std::ostringstream os;
+	xmlserial::Save(s,os);
+	std::istringstream is(os.str());
+	std::string ret = "old";
+	xmlserial::Load(ret,is);
+	return ret;
+}
+
+static std::string load(const std::string &text) {
+	std::istringstream is(text);
+	std::string ret;
+	xmlserial::Load(ret,is);
+	return ret;
+}
+
+int main() {
+	// every character that is escaped, at every position near the
+	// loader's blocks (of 8192 characters)
+	const char special[] = "\\&<>\"'\n\t\r\a\b\f\v";
+	for(int c=0;special[c];c++)
+		for(std::size_t at=8180;at<8200;at++) {
+			std::string s(8300,'x');
+			s[at] = special[c];
+			s[at+1] = special[(c+1)%13];
+			CHECK(roundtrip(s)==s);
+		}
+	const std::size_t ns[] = { 0, 1, 19, 20, 21, 8191, 8192, 8193,
+		3*8192+7 };
+	for(std::size_t k=0;k<sizeof(ns)/sizeof(ns[0]);k++) {
+		std::string s(ns[k],'a');
+		for(std::size_t i=0;i<s.size();i++)
+			s[i] = char(32+(i*7)%95);
+		CHECK(roundtrip(s)==s);
+	}
+
+	// len is a hint only
+	std::string s = "a string that is longer than twenty";
+	std::ostringstream os;
+	xmlserial::Save(s,os);
+	std::string text = os.str();
+	const std::string len = "len=\"35\"";
+	CHECK(text.find(len)!=std::string::npos);
+	const char *lens[] = { "", "len=\"0\"", "len=\"3\"", "len=\"500\"",
+		"len=\"4000000000\"", "len=\"-1\"", "len=\"x\"" };
+	for(std::size_t k=0;k<sizeof(lens)/sizeof(lens[0]);k++) {
+		std::string t = text;
+		t.replace(t.find(len),len.length(),lens[k]);
+		CHECK(load(t)==s);
+	}
+
+	return TestResult();
+}
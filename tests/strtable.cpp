@@ -0,0 +1,97 @@
+/* Test of an archive's string table (archive::strtable):  strings of the
+ * minimum length or more are written once and then referred to, shorter
+ * ones are written every time, everything loads back (in maps and
+ * through pointers too), and references that do not resolve are errors.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/strtable.cpp -o strtable
+ */
+
+#include <string>
+#include <vector>
+#include <map>
+#include <sstream>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_map.h"
+#include "xmlserial_string.h"
+#include "xmlserial_archive.h"
+#include "check.h"
+
+struct Entry {
+	std::string path, tag;
+	std::map<std::string,std::string> props;
+	Entry *parent;
+	Entry() : parent(0) {}
+	XMLSERIALCLASS(Entry,,path,tag,props,parent)
+};
+
+static std::size_t count(const std::string &s, const std::string &what) {
+	std::size_t n = 0;
+	for(std::string::size_type p=0;(p=s.find(what,p))!=std::string::npos;
+			p+=what.length())
+		n++;
+	return n;
+}
+
+static std::string save(const std::vector<Entry *> &v, std::size_t minlen) {
+	std::ostringstream os;
+	xmlserial::archive a(os);
+	a.strtable(minlen);
+	xmlserial::Save(v,a);
+	return os.str();
+}
+
+static std::vector<Entry *> load(const std::string &s) {
+	std::istringstream is(s);
+	xmlserial::archive a(is);
+	std::vector<Entry *> v;
+	xmlserial::Load(v,a);
+	return v;
+}
+
+int main() {
+	std::vector<Entry *> v;
+	for(int i=0;i<50;i++) {
+		Entry *e = new Entry;
+		e->path = "/a/rather/long/common/directory/"+std::to_string(i%5);
+		e->tag = i%2 ? "odd" : "even";
+		e->props["owner"] = "someone with a long name";
+		e->props["mode"] = std::to_string(i%3);
+		e->parent = i ? v[i/2] : 0;
+		v.push_back(e);
+	}
+
+	const std::string with = save(v,10), without = save(v,0);
+	CHECK(with.length()<without.length());
+	// 5 paths and 1 owner in the table, with 50+50-6 references
+	CHECK(count(with,"sid=")==6);
+	CHECK(count(with,"sref=")==94);
+	CHECK(count(without,"sid=")==0);
+	// (short strings are written every time)
+	CHECK(count(with,"\"odd\"")==25);
+
+	for(int k=0;k<2;k++) {
+		std::vector<Entry *> w = load(k ? with : without);
+		CHECK(w.size()==v.size());
+		for(std::size_t i=0;i<w.size() && i<v.size();i++) {
+			CHECK(w[i]->path==v[i]->path);
+			CHECK(w[i]->tag==v[i]->tag);
+			CHECK(w[i]->props==v[i]->props);
+			CHECK(i==0 || w[i]->parent==w[i/2]);
+		}
+	}
+
+	// references need an archive, and must resolve
+	std::istringstream plain(with);
+	std::vector<Entry *> w;
+	CHECK_THROWS(xmlserial::Load(w,plain),xmlserial::streamexception);
+	std::string bad = with;
+	bad.replace(bad.find("sref=\"")+6,1,"9");
+	CHECK_THROWS(load(bad),xmlserial::streamexception);
+	std::string order = with;
+	order.replace(order.find("sid=\"0\""),7,"sid=\"3\"");
+	CHECK_THROWS(load(order),xmlserial::streamexception);
+
+	return TestResult();
+}
@@ -0,0 +1,151 @@
+/* Test of validation (xmlserial_validate.h):  what Save writes (by name,
+ * by member id, and with bulk arrays) is valid; a defaulted member may be
+ * missing; and changed tags, members, numbers and element counts are
+ * found, as Load finds them (numbers more strictly).
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/validate.cpp -o validate
+ */
+
+#include <string>
+#include <vector>
+#include <map>
+#include <sstream>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "xmlserial_string.h"
+#include "xmlserial_map.h"
+#include "xmlserial_validate.h"
+#include "check.h"
+
+struct Point {
+	int x;
+	double y;
+	Point() : x(0), y(0) {}
+	XMLSERIALCLASS(Point,,x,y)
+};
+
+struct Rec {
+	int id;
+	bool flag;
+	std::vector<double> values;
+	std::vector<Point> points;
+	std::string label;
+	std::map<int,std::string> names;
+	Point *where;
+	int extra;
+	Rec() : id(0), flag(false), where(0), extra(5) {}
+	XMLSERIALCLASS(Rec,,id,flag,values,points,label,names,where,
+		(extra,"extra",5))
+};
+
+static bool valid(const std::string &s) {
+	std::istringstream is(s);
+	try {
+		xmlserial::Validate<Rec>(is);
+	} catch(xmlserial::streamexception &) {
+		return false;
+	}
+	return true;
+}
+
+static bool loads(const std::string &s) {
+	std::istringstream is(s);
+	Rec r;
+	try {
+		xmlserial::Load(r,is);
+	} catch(xmlserial::streamexception &) {
+		return false;
+	}
+	return true;
+}
+
+// s with the first a replaced by b
+static std::string change(std::string s, const std::string &a,
+		const std::string &b) {
+	std::size_t p = s.find(a);
+	CHECK(p!=std::string::npos);
+	if (p!=std::string::npos) s.replace(p,a.length(),b);
+	return s;
+}
+
+int main() {
+	Rec r;
+	r.id = 3;
+	r.flag = true;
+	r.values.push_back(1);
+	r.values.push_back(2.5);
+	r.values.push_back(-3e10);
+	r.points.resize(2);
+	r.points[1].x = 7;
+	r.label = "a <label>";
+	r.names[1] = "one";
+	r.where = new Point;
+	r.where->y = 0.25;
+	r.extra = 1;
+
+	std::ostringstream os, mos, bos;
+	xmlserial::Save(r,os);
+	mos << xmlserial::memberids;
+	xmlserial::Save(r,mos);
+	bos << xmlserial::bulkarrays;
+	xmlserial::Save(r,bos);
+	const std::string buf = os.str();
+	CHECK(valid(buf));
+	CHECK(valid(mos.str()));
+	CHECK(valid(bos.str()));
+	CHECK(bos.str().find("enc=")!=std::string::npos);
+
+	// a member with a default may be missing; others may not
+	std::string nodef = change(buf,"<int name=\"extra\" value=\"1\" \\>","");
+	CHECK(valid(nodef) && loads(nodef));
+	std::string noid = change(buf,"<int name=\"id\" value=\"3\" \\>","");
+	CHECK(!valid(noid) && !loads(noid));
+
+	// tags
+	const char *badtags[][2] = {
+		{ "<\\Rec>", "<\\Req>" },             // another end tag
+		{ "<int name=\"id\"", "<long name=\"id\"" }, // another type
+		{ "<vector.double", "<vector.int" },  // another element type
+		{ "name=\"label\"", "name=\"title\"" }, // no such member
+		{ "<\\Point>", "<\\P>" },             // within
+		{ "<\\vector>", "" },                 // not ended
+		{ "\\>", ">" },                       // not self-closing
+		{ "<Rec>", "<>" },                    // no name
+	};
+	for(std::size_t i=0;i<sizeof(badtags)/sizeof(badtags[0]);i++) {
+		std::string b = change(buf,badtags[i][0],badtags[i][1]);
+		if (valid(b) || loads(b))
+			std::cerr << "(tag case " << i << ")" << std::endl;
+		CHECK(!valid(b));
+		CHECK(!loads(b));
+	}
+	// cut short
+	CHECK(!valid(buf.substr(0,buf.size()/2)));
+	CHECK(!valid(""));
+
+	// numbers
+	const char *badnums[][2] = {
+		{ "value=\"3\"", "value=\"3x\"" },
+		{ "value=\"3\"", "value=\"\"" },
+		{ "value=\"3\"", "value=\"0x3\"" },
+		{ "value=\"1\"", "value=\"2\"" }, // (a bool)
+		{ "2.5 ", "2..5 " },
+		{ "-30000000000", "-3e1e0" },
+		{ "value=\"0.25\"", "value=\"0.25.\"" },
+	};
+	for(std::size_t i=0;i<sizeof(badnums)/sizeof(badnums[0]);i++) {
+		std::string b = change(buf,badnums[i][0],badnums[i][1]);
+		if (valid(b))
+			std::cerr << "(number case " << i << ")" << std::endl;
+		CHECK(!valid(b));
+	}
+	// (but white space and exponents are fine)
+	CHECK(valid(change(buf,"2.5 ","\n 25e-1\t ")));
+
+	// element counts
+	CHECK(!valid(change(buf,"nelem=\"3\"","nelem=\"4\"")));
+	CHECK(!valid(change(buf,"1 2.5","1 7 2.5")));
+
+	return TestResult();
+}
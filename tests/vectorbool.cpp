@@ -0,0 +1,80 @@
+/* Test of std::vector<bool> (xmlserial_vector.h):  vectors of every
+ * length near a byte, a word and a block round trip with their bits
+ * packed, the older one-0-or-1-per-element form still loads, and short
+ * or malformed bit data is an error.
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -std=c++11 -I. tests/vectorbool.cpp -o vectorbool
+ * (and with -D_GLIBCXX_DEBUG, for libstdc++'s checked vector<bool>).
+ */
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include "xmlserial.h"
+#include "xmlserial_vector.h"
+#include "check.h"
+
+struct Flags {
+	int before;
+	std::vector<bool> bits;
+	std::vector<bool> more;
+	XMLSERIALCLASS(Flags,,before,bits,more)
+};
+
+static std::vector<bool> pattern(std::size_t n, unsigned seed) {
+	std::vector<bool> v(n);
+	for(std::size_t i=0;i<n;i++)
+		v[i] = ((i+seed)*2654435761u>>7)&1;
+	return v;
+}
+
+int main() {
+	// lengths near a byte, a 64-bit word, and a block of the writer's
+	// (3*8*256 bytes)
+	const std::size_t block = 3*8*256*8;
+	std::vector<std::size_t> ns;
+	for(std::size_t n=0;n<=130;n++) ns.push_back(n);
+	for(int d=-9;d<=9;d++) {
+		ns.push_back(block+d);
+		ns.push_back(3*block+d);
+	}
+	for(std::size_t k=0;k<ns.size();k++) {
+		Flags f, g;
+		f.before = int(k);
+		f.bits = pattern(ns[k],unsigned(k));
+		f.more = pattern(ns[k]%13,unsigned(k)+1);
+		std::ostringstream os;
+		xmlserial::Save(f,os);
+		std::istringstream is(os.str());
+		g.bits.resize(5,true); // (replaced, not added to)
+		xmlserial::Load(g,is);
+		CHECK(g.before==f.before);
+		CHECK(g.bits==f.bits);
+		CHECK(g.more==f.more);
+	}
+
+	// bits not from the start of a word:  the tail of a longer vector
+	std::vector<bool> w = pattern(1000,5);
+	std::vector<bool> tail(w.begin()+37,w.end()), tail2;
+	std::ostringstream os;
+	xmlserial::Save(tail,os);
+	std::istringstream is(os.str());
+	xmlserial::Load(tail2,is);
+	CHECK(tail2==tail);
+	CHECK(os.str().find("nbits=\"963\"")!=std::string::npos);
+
+	// the older form
+	std::istringstream old("<vector.bool nelem=\"5\">1 0 1 1 0 <\\vector.bool>");
+	std::vector<bool> o;
+	xmlserial::Load(o,old);
+	CHECK(o.size()==5 && o[0] && !o[1] && o[2] && o[3] && !o[4]);
+
+	// too few bits for nbits, and not base64
+	std::istringstream shortdata("<vector.bool nbits=\"30\" enc=\"b64\">AAAA<\\vector.bool>");
+	CHECK_THROWS(xmlserial::Load(o,shortdata),xmlserial::streamexception);
+	std::istringstream bad("<vector.bool nbits=\"8\" enc=\"b64\">A!A=<\\vector.bool>");
+	CHECK_THROWS(xmlserial::Load(o,bad),xmlserial::streamexception);
+
+	return TestResult();
+}
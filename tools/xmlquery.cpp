@@ -0,0 +1,85 @@
+/* xmlquery: prints the values in serialized files matched by a path,
+ * without knowing the types that were written (see xmlserial_query.h for
+ * the form of paths).
+ *
+ * Build from the top directory with, for example,
+ *   g++ -O2 -I. tools/xmlquery.cpp -o xmlquery
+ *
+ * Usage:  xmlquery [-c] [-l] PATH [FILE...]
+ *   reads the standard input if no files are given
+ *   -c    print only the number of matches
+ *   -l    print where each match is (its tags from the top, joined by /)
+ *         and a tab before its value; elements that hold other elements
+ *         (which have no value) are printed only with -l
+ *
+ * For example,
+ *   xmlquery 'Portfolio/@holdings/Holding/@price' snapshot.xml
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstring>
+#include "xmlserial.h"
+#include "xmlserial_query.h"
+
+struct printer {
+	printer(bool l) : where(l) {}
+	void operator()(const xmlserial::querymatch &m) {
+		if (where) {
+			for(std::size_t i=0;i<m.path.size();i++)
+				std::cout << (i ? "/" : "") << m.path[i];
+			std::cout << '\t';
+		} else if (m.haschildren) return;
+		std::cout << m.value << '\n';
+	}
+	bool where;
+};
+
+struct counter {
+	void operator()(const xmlserial::querymatch &) { }
+};
+
+static std::size_t run(std::istream &is, const xmlserial::pathquery &q,
+		bool count, bool where) {
+	if (count) {
+		counter c;
+		return xmlserial::Query(is,q,c);
+	}
+	printer p(where);
+	return xmlserial::Query(is,q,p);
+}
+
+int main(int argc, char **argv) {
+	bool count = false, where = false;
+	int i = 1;
+	for(;i<argc && argv[i][0]=='-' && argv[i][1];i++) {
+		if (!strcmp(argv[i],"-c")) count = true;
+		else if (!strcmp(argv[i],"-l")) where = true;
+		else break;
+	}
+	if (i>=argc || argv[i][0]=='-') {
+		std::cerr << "usage: " << argv[0] << " [-c] [-l] PATH [FILE...]"
+			<< std::endl;
+		return 2;
+	}
+	std::size_t n = 0;
+	try {
+		xmlserial::pathquery q(argv[i++]);
+		if (i==argc) n = run(std::cin,q,count,where);
+		for(;i<argc;i++) {
+			std::ifstream f(argv[i],std::ios::in|std::ios::binary);
+			if (!f) {
+				std::cerr << argv[0] << ": cannot open " << argv[i]
+					<< std::endl;
+				return 2;
+			}
+			n += run(f,q,count,where);
+		}
+	} catch(const xmlserial::streamexception &e) {
+		std::cerr << argv[0] << ": " << e.what() << std::endl;
+		return 2;
+	}
+	if (count) std::cout << n << '\n';
+	return n ? 0 : 1;
+}
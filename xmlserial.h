@@ -40,8 +40,23 @@
 #include <utility>
 #include <map>
 #include <set>
+#include <vector>
+#include <locale>
+#include <clocale>
+#include <cstdio>
+#include <limits>
 #include <string.h>
 
+// shortest float formatting from the standard library, if it has it
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#if defined(__cpp_lib_to_chars)
+#define XMLSERIAL_TO_CHARS
+#endif
+#endif
+#endif
+
 
 #ifndef XMLSERIALNAMESPACE
 #define XMLSERIALNAMESPACE xmlserial
@@ -52,11 +67,14 @@
 	enum { vname = (expr) };
 	//static int const vname = (expr);
 	
-#if _cplusplus <= 199711L
+#if __cplusplus <= 199711L
 #define nullptr (0)
 #endif
 
 #include "xmlserial_tmp.h"
+#include "xmlserial_stats.h"
+#include "xmlserial_observer.h"
+#include "xmlserial_profile.h"
 #include "xmlserial_ptrs.h"
 #include "xmlserial_archive.h"
 
@@ -77,6 +95,57 @@ namespace XMLSERIALNAMESPACE {
 		std::string expl;
 	};
 
+	// optional encodings are kept as bits in the stream's iword storage
+	// (set and cleared with the manipulators below)
+	enum { ENC_BULKARRAYS = 1, ENC_STREAMFLOATS = 2, ENC_BLOBSTRINGS = 4,
+		ENC_MEMBERIDS = 8 };
+
+	inline int EncIndex() {
+		static int i = std::ios_base::xalloc();
+		return i;
+	}
+
+	template<typename S>
+	inline bool HasEnc(S &s, long f) {
+		return (s.iword(EncIndex()) & f) != 0;
+	}
+
+	// write arrays of numbers as raw (little-endian) bytes in base64
+	inline std::ostream &bulkarrays(std::ostream &os) {
+		os.iword(EncIndex()) |= ENC_BULKARRAYS;
+		return os;
+	}
+
+	// write arrays of numbers as text (the default)
+	inline std::ostream &textarrays(std::ostream &os) {
+		os.iword(EncIndex()) &= ~long(ENC_BULKARRAYS);
+		return os;
+	}
+
+	// write (long) strings and arrays of bytes as base64 blobs
+	inline std::ostream &blobstrings(std::ostream &os) {
+		os.iword(EncIndex()) |= ENC_BLOBSTRINGS;
+		return os;
+	}
+
+	// write strings as escaped text (the default)
+	inline std::ostream &textstrings(std::ostream &os) {
+		os.iword(EncIndex()) &= ~long(ENC_BLOBSTRINGS);
+		return os;
+	}
+
+	// identify class members by number (mid="3") instead of by name
+	inline std::ostream &memberids(std::ostream &os) {
+		os.iword(EncIndex()) |= ENC_MEMBERIDS;
+		return os;
+	}
+
+	// identify class members by name (the default)
+	inline std::ostream &membernames(std::ostream &os) {
+		os.iword(EncIndex()) &= ~long(ENC_MEMBERIDS);
+		return os;
+	}
+
 	// from s2 to s1!
 	template<typename S1, typename S2>
 	void dupfmt(S1 &s1, S2 &s2) {
@@ -84,8 +153,99 @@ namespace XMLSERIALNAMESPACE {
 		s1.precision(s2.precision());
 		s1.width(s2.width());
 		s1.imbue(s2.getloc());
+		s1.iword(EncIndex()) = s2.iword(EncIndex());
+	}
+
+	// write floats and doubles with << (and so the stream's precision)
+	inline std::ostream &streamfloats(std::ostream &os) {
+		os.iword(EncIndex()) |= ENC_STREAMFLOATS;
+		return os;
 	}
 
+	// write floats and doubles with the fewest digits that read back
+	// exactly (the default)
+	inline std::ostream &shortfloats(std::ostream &os) {
+		os.iword(EncIndex()) &= ~long(ENC_STREAMFLOATS);
+		return os;
+	}
+
+	// is the C library's (printf's and strtod's) decimal point a . (as
+	// in the "C" locale)?
+	inline bool CDecimalIsDot() {
+		const char *d = std::localeconv()->decimal_point;
+		return d[0]=='.' && d[1]==0;
+	}
+
+	// shortest text for t that reads back as t (buf needs 32 chars)
+	// returns the number of characters
+#ifdef XMLSERIAL_TO_CHARS
+	// (to_chars does not depend on any locale)
+	inline bool ShortFloatsNeedStream() { return false; }
+
+	template<typename T>
+	inline int ShortestFloat(char *buf, T t) {
+		return std::to_chars(buf,buf+32,t).ptr-buf;
+	}
+#else
+	// (sprintf and strtod use the C locale)
+	inline bool ShortFloatsNeedStream() { return !CDecimalIsDot(); }
+
+	inline bool ReadsBack(const char *buf, double t) {
+		return strtod(buf,0)==t;
+	}
+	inline bool ReadsBack(const char *buf, float t) {
+#if __cplusplus > 199711L
+		return strtof(buf,0)==t;
+#else
+		return (float)strtod(buf,0)==t;
+#endif
+	}
+	template<typename T>
+	inline int ShortestFloat(char *buf, T t) {
+		// 17 digits (9 for float) always read back, and rounding to
+		// 15 (6) digits gives the shortest text whenever it is that short;
+		// subnormals have fewer digits of their own, so for them every
+		// length is tried
+		const bool sub = t!=0 && t<std::numeric_limits<T>::min()
+			&& -t<std::numeric_limits<T>::min();
+		const int mindig = sub ? 1 : sizeof(T)>4 ? 15 : 6;
+		const int maxdig = sizeof(T)>4 ? 17 : 9;
+		int n;
+		for(int p=mindig;;p++) {
+			n = snprintf(buf,32,"%.*g",p,(double)t);
+			if (p==maxdig || ReadsBack(buf,t)) return n;
+		}
+	}
+#endif
+
+	// how numbers are written
+	template<typename S, typename T>
+	inline void WriteNum(S &os, const T &t) {
+		os << t;
+	}
+
+	template<typename S, typename T>
+	inline void WriteFloat(S &os, T t) {
+		// only if the stream's format is not otherwise asked for
+		if (HasEnc(os,ENC_STREAMFLOATS)
+				|| (os.flags() & (std::ios_base::floatfield
+					| std::ios_base::showpos | std::ios_base::uppercase
+					| std::ios_base::showpoint))
+				|| os.width()!=0
+				|| !(os.getloc()==std::locale::classic())
+				|| ShortFloatsNeedStream()) {
+			os << t;
+			return;
+		}
+		char buf[32];
+		os.write(buf,ShortestFloat(buf,t));
+	}
+
+	template<typename S>
+	inline void WriteNum(S &os, const double &t) { WriteFloat(os,t); }
+	template<typename S>
+	inline void WriteNum(S &os, const float &t) { WriteFloat(os,t); }
+
 }
 
 /* Here starts "helper" macros: */
@@ -111,6 +271,19 @@ namespace XMLSERIALNAMESPACE {
 			static inline void setdefault(vtype &v) { v = dval; } \
 		} 
 
+#define XMLSERIAL_GETTERSTRUCT_ID(expr,cexpr,vtype,vname,mid) \
+		struct { \
+			XMLSERIAL_GETTERCOMMON(expr,cexpr,vtype,vname) \
+			static inline int xmlserial_mid() { return mid; } \
+		}
+
+#define XMLSERIAL_GETTERSTRUCT_DEFAULT_ID(expr,cexpr,vtype,vname,dval,mid) \
+		struct { \
+			XMLSERIAL_GETTERCOMMON(expr,cexpr,vtype,vname) \
+			static inline void setdefault(vtype &v) { v = dval; } \
+			static inline int xmlserial_mid() { return mid; } \
+		} 
+
 #define XMLSERIAL_NOTV_COMMON \
 	friend struct XMLSERIALNAMESPACE::IsEmpty<XMLSERIAL_BASETYPE,void>; \
 	private: \
@@ -134,6 +307,30 @@ namespace XMLSERIALNAMESPACE {
 				{ return name; } \
 		}; \
 
+// Compiled with XMLSERIAL_STRUCTURAL defined (the same in every file),
+// polymorphic classes get virtual methods through which Clone, Hash and
+// Equal walk objects of subclasses directly.  Otherwise those go through
+// the objects' text (see xmlserial_clone.h), and classes that never use
+// them need nothing more than Save and Load do.
+#ifdef XMLSERIAL_STRUCTURAL
+#define XMLSERIAL_STRUCTURAL_V \
+		virtual void xmlserial_clonev(const void *src, \
+					XMLSERIALNAMESPACE::cloner &c) { \
+			XMLSERIALNAMESPACE::CloneWrapper( \
+				*static_cast<const XMLSERIAL_BASETYPE *>(src),*this,c); \
+		} \
+		virtual void xmlserial_hashv(XMLSERIALNAMESPACE::hasher &h) const { \
+			XMLSERIALNAMESPACE::HashWrapper(*this,h); \
+		} \
+		virtual bool xmlserial_equalv(const void *other, \
+					XMLSERIALNAMESPACE::comparer &c) const { \
+			return XMLSERIALNAMESPACE::EqualWrapper(*this, \
+				*static_cast<const XMLSERIAL_BASETYPE *>(other),c); \
+		}
+#else
+#define XMLSERIAL_STRUCTURAL_V
+#endif
+
 #define XMLSERIAL_P_COMMON(myname) \
 	friend struct XMLSERIALNAMESPACE::IsEmpty<XMLSERIAL_BASETYPE,void>; \
 	private: \
@@ -146,6 +343,7 @@ namespace XMLSERIALNAMESPACE {
 			template<typename PTRT> \
 			inline static void allocbyname(const std::string &name, \
 					PTRT &ret) { \
+				XMLSERIAL_COUNT(factory_lookups,1); \
 				typename allocmaptype::iterator i = alloctable().find(name); \
 				if (i==alloctable().end()) \
 					XMLSERIALNAMESPACE::PtrInfo<PTRT>::setnull(ret); \
@@ -184,7 +382,11 @@ namespace XMLSERIALNAMESPACE {
 		virtual void xmlserial_loadwrapv(XMLSERIALNAMESPACE::archive &ia, \
 					const XMLSERIALNAMESPACE::XMLTagInfo &info) { \
 			XMLSERIALNAMESPACE::LoadWrapper(*this,info,ia); \
-		}
+		} \
+		virtual const char *xmlserial_namev() const { \
+			return xmlserial_IDname(); \
+		} \
+		XMLSERIAL_STRUCTURAL_V
 
 
 #define XMLSERIAL_NAME0(cname) \
@@ -519,6 +721,20 @@ namespace XMLSERIALNAMESPACE {
 			xmlserial_get##vname; \
 		typedef XMLSERIALNAMESPACE::List<xmlserial_get##vname,xmlserial_##vname##lst>
 
+// member ids (see memberids) are normally the position in the list;
+// these fix the id, so that it does not change if members are reordered
+#define XMLSERIAL_VAR_ID(vtype,vname,mid) \
+		xmlserial_##vname##lst; \
+		typedef XMLSERIAL_GETTERSTRUCT_ID((o->vname),(o->vname),vtype,#vname,mid) \
+			xmlserial_get##vname; \
+		typedef XMLSERIALNAMESPACE::List<xmlserial_get##vname,xmlserial_##vname##lst>
+
+#define XMLSERIAL_VAR_DEFAULT_ID(vtype,vname,val,mid) \
+		xmlserial_##vname##lst; \
+		typedef XMLSERIAL_GETTERSTRUCT_DEFAULT_ID((o->vname),(o->vname),vtype,#vname,val,mid) \
+			xmlserial_get##vname; \
+		typedef XMLSERIALNAMESPACE::List<xmlserial_get##vname,xmlserial_##vname##lst>
+
 /* Here starts "BASE" macros */
 
 #define XMLSERIAL_BASE(basename) \
@@ -615,8 +831,7 @@ namespace XMLSERIALNAMESPACE {
         } \
         template<typename S> \
         inline void Save(S &os, int indent=0) const { \
-		XMLSERIALNAMESPACE::XMLTagInfo fields; \
-            XMLSERIALNAMESPACE::SaveWrapper(*this,fields,os,indent); \
+            XMLSERIALNAMESPACE::Save(*this,os,indent); \
         } \
         template<typename S> \
         inline void xmlserial_Load(S &is) { \
@@ -649,6 +864,8 @@ namespace XMLSERIALNAMESPACE {
 namespace XMLSERIALNAMESPACE {
 	template<typename S>
 	void WriteStr(S &os, const std::string &s,bool escape=true);
+	template<typename S>
+	void WriteStr(S &os, const char *b, const char *e, bool escape);
 
 	// helpful formatting fn
 	template<typename S>
@@ -662,8 +879,14 @@ namespace XMLSERIALNAMESPACE {
 		std::map<std::string,std::string> attr;
 		bool isstart,isend;
 
+#ifdef XMLSERIAL_STATS
+		XMLTagInfo() { XMLSERIAL_COUNT(taginfos,1); }
+#endif
+
+		// (tags_written counts start and end tags, as tags_read does)
 		template<typename S>
 		void write(S &os, int indent) const {
+			XMLSERIAL_COUNT(tags_written,1);
 			if (isstart) {
 				Indent(os,indent);
 				os << "<" << name;
@@ -675,16 +898,16 @@ namespace XMLSERIALNAMESPACE {
 					WriteStr(os,i->second);
 					os << "\"";
 				}
-				if (isend) os << " \\>" << std::endl;
+				if (isend) os << " \\>\n";
 				else os << ">";
 			} else {
-				os << "<\\" << name << ">" << std::endl;
+				os << "<\\" << name << ">\n";
 			}
 		}
 	};
 
 	// forward decls
-	template<typename G> struct SaveItem;
+	template<typename G,typename Condition=void> struct SaveItem;
 	template<typename L> struct LoadList;
 	template<typename S>
 	void ReadTag(S &is,XMLTagInfo &info);
@@ -704,9 +927,7 @@ namespace XMLSERIALNAMESPACE {
 	}
 
 
-	template<typename S>
-	char ReadEscChar(S &is) {
-		char c=is.get();
+	inline char EscChar(char c) {
 		switch(c) {
 			case '\\': return '\\';
 			case 'a': return '\a';
@@ -720,6 +941,11 @@ namespace XMLSERIALNAMESPACE {
 		}
 	}
 
+	template<typename S>
+	char ReadEscChar(S &is) {
+		return EscChar(is.get());
+	}
+
 	template<typename S>
 	bool ConsumeToken(S &is, const char *tok) {
 		int i;
@@ -741,6 +967,19 @@ namespace XMLSERIALNAMESPACE {
 		return '&';
 	}
 
+	// as ReadAmpChar, but from the n characters at s (just after the &)
+	// len is set to the number used
+	inline char AmpChar(const char *s, std::size_t n, std::size_t &len) {
+		static const char *tok[] = { "quot;", "amp;", "apos;", "lt;", "gt;" };
+		static const char ch[] = { '"', '&', '\'', '<', '>' };
+		for(int i=0;i<5;i++) {
+			len = strlen(tok[i]);
+			if (len<=n && !memcmp(s,tok[i],len)) return ch[i];
+		}
+		len = 0;
+		return '&';
+	}
+
 	template<typename S>
 	void ReadToken(S &is, std::string &ret) {
 		ret.clear();
@@ -768,9 +1007,57 @@ namespace XMLSERIALNAMESPACE {
 		}
 	}
 
+	// appends the text up to the next < to ret (as ReadStr(is,ret,"<")
+	// but a block at a time:  runs of characters that are not escaped
+	// are appended whole)
+	template<typename S>
+	void ReadText(S &is, std::string &ret) {
+		enum { BLOCK = 1<<13 };
+		char buf[BLOCK+1];
+		std::size_t keep = 0; // an escape cut off by the end of the block
+		bool done = false;
+		while(!done) {
+			std::streamsize want = BLOCK-keep;
+			is.get(buf+keep,want+1,'<');
+			std::streamsize got = is.gcount();
+			if (got<want) {
+				done = true;
+				// get fails if the < is immediately next
+				if (got==0 && !(is.rdstate() & std::ios_base::badbit))
+					is.clear(is.rdstate() & ~std::ios_base::failbit);
+			}
+			const char *p = buf, *end = buf+keep+got;
+			while(p<end) {
+				const char *q = p;
+				while(q<end && *q!='\\' && *q!='&') ++q;
+				ret.append(p,q);
+				p = q;
+				if (p==end) break;
+				// the longest escape (&quot;) is 6 characters
+				if (!done && end-p<6) break;
+				if (*p=='\\') {
+					if (p+1<end) ret.push_back(EscChar(p[1]));
+					p += 2;
+				} else {
+					std::size_t len;
+					ret.push_back(AmpChar(p+1,end-p-1,len));
+					p += 1+len;
+				}
+			}
+			keep = p<end ? end-p : 0;
+			if (keep) memmove(buf,p,keep);
+		}
+	}
+
 	template<typename S>
 	void WriteStr(S &os, const std::string &s,bool escape) {
-		for(std::string::const_iterator i=s.begin();i!=s.end();++i) {
+		WriteStr(os,s.data(),s.data()+s.length(),escape);
+	}
+
+	// the characters [b,e)
+	template<typename S>
+	void WriteStr(S &os, const char *b, const char *e, bool escape) {
+		for(const char *i=b;i!=e;++i) {
 			switch(*i) {
 				case '"':
 				    os << "&quot;";
@@ -821,6 +1108,7 @@ namespace XMLSERIALNAMESPACE {
 
 	template<typename S>
 	void ReadTag(S &is,XMLTagInfo &info) {
+		XMLSERIAL_COUNT(tags_read,1);
 		info.attr.clear();
 		IgnoreWS(is);
 		char c = is.get();
@@ -855,6 +1143,7 @@ namespace XMLSERIALNAMESPACE {
 			ReadToken(is,aname);
 			if (aname.empty()) 
 				throw streamexception("Stream Input Format Error: tag missing name");
+			XMLSERIAL_COUNT(attrs_read,1);
 			IgnoreWS(is);
 			if (is.peek()=='=') {
 				is.get();
@@ -929,6 +1218,30 @@ namespace XMLSERIALNAMESPACE {
 
 
 
+	// number of elements in a list
+	template<typename L>
+	struct ListLen {
+		XMLSERIAL_DECVAL(value,0)
+	};
+
+	template<typename H, typename T>
+	struct ListLen<List<H,T> > {
+		XMLSERIAL_DECVAL(value,1+ListLen<T>::value)
+	};
+
+	// the id of member H, which heads the list List<H,T>:  the number
+	// of members before it (the list is built backwards), unless fixed
+	// with XMLSERIAL_VAR_ID
+	template<typename H, typename T, typename Condition=void>
+	struct MemberId {
+		inline static int id() { return ListLen<T>::value; }
+	};
+
+	template<typename H, typename T>
+	struct MemberId<H,T,typename Type_If<TypeProp<H>::HasMemberId,void>::type> {
+		inline static int id() { return H::xmlserial_mid(); }
+	};
+
 	// a reverse iterator on a list for saving
 	// runs SaveItem on each element in list
 	template<typename L,typename Condition=void>
@@ -943,7 +1256,7 @@ namespace XMLSERIALNAMESPACE {
 		template<typename O, typename S>
 		inline static void exec(O o,S &os,int indent) {
 				SaveItt<T>::exec(o,os,indent);
-				SaveItem<H>::exec(o,os,indent);
+				SaveItem<H>::exec(o,os,indent,MemberId<H,T>::id());
 		}
 	};
 
@@ -989,6 +1302,10 @@ namespace XMLSERIALNAMESPACE {
 			std::map<std::string,std::string>::const_iterator ni
 				=info.attr.find("name");
 			if (ni!=info.attr.end() && ni->second == H::getname(o)) {
+				XMLSERIAL_PROFILE_LOAD(S,OwnerName<O>::name(),
+					H::getname(o),is);
+				XMLSERIAL_OBSERVE_LOAD(S,OwnerName<O>::name(),
+					H::getname(o),is);
 				LoadWrapper(H::getvalue(o),info,is);
 				return true;
 			} else
@@ -1084,7 +1401,7 @@ namespace XMLSERIALNAMESPACE {
 		inline static bool isinline(const tname &) { return false; } \
 		template<typename S> \
 		inline static void save(const tname &t,S &os, int indent) { \
-			os << t; \
+			WriteNum(os,t); \
 		} \
 		template<typename S> \
 		inline static void load(tname &t, const XMLTagInfo &info, S &is) {\
@@ -1092,6 +1409,7 @@ namespace XMLSERIALNAMESPACE {
 			=info.attr.find("value"); \
 			if (vi!=info.attr.end()) { \
 				std::istringstream ss(vi->second); \
+				XMLSERIAL_COUNT(stringstreams,1); \
 				dupfmt(ss,is); \
 				ss >> t; \
 				if (info.isend) return; \
@@ -1198,6 +1516,7 @@ namespace XMLSERIALNAMESPACE {
 		return std::to_string(i);
 #else
 		std::ostringstream ss;
+		XMLSERIAL_COUNT(stringstreams,1);
 		ss << i;
 		return ss.str();
 #endif
@@ -1206,6 +1525,7 @@ namespace XMLSERIALNAMESPACE {
 	// General save (for objects not modified, like std::vector or pointers)
 	template<typename T, typename S>
 	void Save(const T &v, S &os, int indent = 0) {
+		StatsWrite<S> count(os);
 		XMLTagInfo fields;
 		SaveWrapper(v,fields,os,indent);
 	}
@@ -1220,6 +1540,7 @@ namespace XMLSERIALNAMESPACE {
 		TypeInfo<T>::addotherattr(fields,v,os);
 		if (TypeInfo<T>::isshort(v)) {
 			std::ostringstream ss;
+			XMLSERIAL_COUNT(stringstreams,1);
 			dupfmt(ss,os);
 			TypeInfo<T>::save(v,ss,indent);
 			fields.attr["value"] = ss.str();
@@ -1233,6 +1554,38 @@ namespace XMLSERIALNAMESPACE {
 		}
 	}
 
+	// pointers held by another stream (see xmlserial_shard.h); there are
+	// none, except for archives that are shards
+	template<typename S>
+	struct ForeignPtr {
+		// adds to fields if the pointer findoradd just found is held
+		// by another stream
+		inline static void save(XMLTagInfo &, S &) {}
+		// returns true if info is for a pointer held by another stream
+		// (which is then set later)
+		template<typename T>
+		inline static bool load(T &, const XMLTagInfo &, S &) {
+			return false;
+		}
+	};
+
+	template<>
+	struct ForeignPtr<archive> {
+		inline static void save(XMLTagInfo &fields, archive &os) {
+			if (os.refshard()>=0)
+				fields.attr["xshard"] = T2str(os.refshard());
+		}
+		template<typename T>
+		inline static bool load(T &v, const XMLTagInfo &info, archive &is) {
+			if (!is.isshard()) return false;
+			std::map<std::string,std::string>::const_iterator
+				x = info.attr.find("xshard"), i = info.attr.find("ptrid");
+			if (x==info.attr.end() || i==info.attr.end()) return false;
+			is.deferptr(v,atoi(x->second.c_str()),atoi(i->second.c_str()));
+			return true;
+		}
+	};
+
 	// Saving method, pointer, virtual, no ptr cache
 	template<typename T, typename S>
 	inline typename Type_If<PtrInfo<T>::isptr
@@ -1280,6 +1633,7 @@ namespace XMLSERIALNAMESPACE {
 			int id;
 			if (os.findoradd(v,id)) {
 				fields.attr["ptrid"] = T2str(id);
+				ForeignPtr<S>::save(fields,os);
 				fields.isstart = true;
 				fields.isend = true;
 				fields.name = TypeInfo<typename PtrInfo<T>::BaseType>::namestr();
@@ -1307,6 +1661,7 @@ namespace XMLSERIALNAMESPACE {
 			int id;
 			if (os.findoradd(v,id)) {
 				fields.attr["ptrid"] = T2str(id);
+				ForeignPtr<S>::save(fields,os);
 				fields.isstart = true;
 				fields.isend = true;
 				fields.name = TypeInfo<typename PtrInfo<T>::BaseType>::namestr();
@@ -1350,6 +1705,7 @@ namespace XMLSERIALNAMESPACE {
 	// general Load (first read tag)
 	template<typename T, typename S>
 	inline void Load(T &v, S &is) {
+		StatsRead<S> count(is);
 		XMLTagInfo info;
 		ReadTag(is,info);
 		LoadWrapper(v,info,is);
@@ -1433,6 +1789,7 @@ namespace XMLSERIALNAMESPACE {
 		}
 		vi = info.attr.find("ptrid");
 		if (vi!=info.attr.end()) {
+			if (ForeignPtr<S>::load(v,info,is)) return;
 			int id = atoi(vi->second.c_str());
 			if (is.validid(id)) {
 				if (!is.lookupptr(id,v))
@@ -1468,6 +1825,7 @@ namespace XMLSERIALNAMESPACE {
 		}
 		vi = info.attr.find("ptrid");
 		if (vi!=info.attr.end()) {
+			if (ForeignPtr<S>::load(v,info,is)) return;
 			int id = atoi(vi->second.c_str());
 			if (is.validid(id)) {
 				if (!is.lookupptr(id,v))
@@ -1559,12 +1917,14 @@ namespace XMLSERIALNAMESPACE {
 		inline static bool isinline(const T &) { return false; }
 		template<typename S>
 		inline static void save(const T &t,S &os,int indent) {
-			os << std::endl;
+			XMLSERIAL_PROFILE_SAVE(S,namestr(),"",os);
+			os << '\n';
 			SerialSaveWrap(t,os,indent+1);
 			Indent(os,indent);
 		}
 		template<typename S>
 		inline static void load(T &t,const XMLTagInfo &info, S &is) {
+			XMLSERIAL_PROFILE_LOAD(S,namestr(),"",is);
 			SerialLoadWrap(t,is);
 		}
 	};
@@ -1588,6 +1948,7 @@ namespace XMLSERIALNAMESPACE {
 				=info.attr.find("value");
 			if (vi!=info.attr.end()) {
 				std::istringstream ss(vi->second);
+				XMLSERIAL_COUNT(stringstreams,1);
 				dupfmt(ss,is);
 				ss >> t;
 				if (info.isend) return;
@@ -1599,17 +1960,93 @@ namespace XMLSERIALNAMESPACE {
 	};
 
 
+	// numbers whose text never needs escaping (so not chars)
+	template<typename T>
+	struct IsQuickTag {
+		XMLSERIAL_DECVAL(value,false);
+	};
+
+#define XMLSERIAL_QUICKTAG(tname) \
+	template<> \
+	struct IsQuickTag<tname> { \
+		XMLSERIAL_DECVAL(value,true); \
+	};
+
+	XMLSERIAL_QUICKTAG(bool)
+	XMLSERIAL_QUICKTAG(short)
+	XMLSERIAL_QUICKTAG(unsigned short)
+	XMLSERIAL_QUICKTAG(int)
+	XMLSERIAL_QUICKTAG(unsigned int)
+	XMLSERIAL_QUICKTAG(long)
+	XMLSERIAL_QUICKTAG(unsigned long)
+#if __cplusplus > 199711L
+	XMLSERIAL_QUICKTAG(long long)
+	XMLSERIAL_QUICKTAG(unsigned long long)
+#endif
+	XMLSERIAL_QUICKTAG(float)
+	XMLSERIAL_QUICKTAG(double)
+	XMLSERIAL_QUICKTAG(long double)
+
+#undef XMLSERIAL_QUICKTAG
+
 	// how to save an item where G is a "getter" for value,type,name
-	template<typename G>
+	template<typename G,typename Condition>
 	struct SaveItem {
 		template<typename T, typename S>
-			inline static void exec(T o,S &os,int indent) {
+			inline static void exec(T o,S &os,int indent,int mid) {
+				XMLSERIAL_PROFILE_SAVE(S,OwnerName<T>::name(),
+					G::getname(o),os);
+				XMLSERIAL_OBSERVE_SAVE(S,OwnerName<T>::name(),
+					G::getname(o),os);
 				XMLTagInfo fields;
-				fields.attr["name"] = G::getname(o);
+				if (HasEnc(os,ENC_MEMBERIDS))
+					fields.attr["mid"] = T2str(mid);
+				else fields.attr["name"] = G::getname(o);
 				SaveWrapper(G::getvalue(o),fields,os,indent);
 			}
 	};
 
+	// ... and if the value is a number, the tag up to the value
+	// (<int name="x" value=") is the same every time, so it is made once
+	template<typename G>
+	struct SaveItem<G,typename Type_If<IsQuickTag<typename G::valtype>::value,void>::type> {
+		template<typename T, typename S>
+			inline static void exec(T o,S &os,int indent,int mid) {
+				// (a locale might group digits with escaped characters,
+				// and a width would pad the tag's text, as it does in
+				// the general path)
+				if (!(os.getloc()==std::locale::classic())
+						|| os.width()!=0) {
+					SaveItem<G,bool>::exec(o,os,indent,mid);
+					return;
+				}
+				XMLSERIAL_PROFILE_SAVE(S,OwnerName<T>::name(),
+					G::getname(o),os);
+				XMLSERIAL_OBSERVE_SAVE(S,OwnerName<T>::name(),
+					G::getname(o),os);
+				static const std::string npre
+					= prefix("name",G::getname(o));
+				static const std::string mpre
+					= prefix("mid",T2str(mid));
+				const std::string &pre
+					= HasEnc(os,ENC_MEMBERIDS) ? mpre : npre;
+				XMLSERIAL_COUNT(tags_written,1);
+				Indent(os,indent);
+				os.write(pre.data(),pre.length());
+				WriteNum(os,G::getvalue(o));
+				os.write("\" \\>\n",5);
+			}
+
+		static std::string prefix(const char *attr, const std::string &v) {
+			std::ostringstream ss;
+			ss << '<' << TypeInfo<typename G::valtype>::namestr()
+				<< ' ' << attr << "=\"";
+			WriteStr(ss,v);
+			ss << "\" value=\"";
+			return ss.str();
+		}
+	};
+
 	// same for Loading
 	template<typename G>
 	struct LoadItem {
@@ -1625,9 +2062,69 @@ namespace XMLSERIALNAMESPACE {
 		}
 	};
 
+	// loading of members by id (mid):  a table, indexed by id, of the
+	// members of an object of type O
+	template<typename O, typename S>
+	struct MemberTable {
+		typedef void (*loadfn)(O, S &, const XMLTagInfo &);
+		typedef const char *(*namefn)(O);
+		struct entry {
+			entry() : load(0), name(0) {}
+			loadfn load;
+			namefn name;
+		};
+		std::vector<entry> members;
+
+		template<typename G>
+		static void loadone(O o, S &is, const XMLTagInfo &info) {
+			XMLSERIAL_PROFILE_LOAD(S,OwnerName<O>::name(),
+				G::getname(o),is);
+			XMLSERIAL_OBSERVE_LOAD(S,OwnerName<O>::name(),
+				G::getname(o),is);
+			LoadWrapper(G::getvalue(o),info,is);
+		}
+		template<typename G>
+		static const char *nameone(O o) { return G::getname(o); }
+	};
+
+	template<typename L>
+	struct FillMemberTable {
+		template<typename O, typename S>
+		inline static void exec(MemberTable<O,S> &, const char *) { }
+	};
+
+	template<typename H, typename T>
+	struct FillMemberTable<List<H,T> > {
+		template<typename O, typename S>
+		inline static void exec(MemberTable<O,S> &tab, const char *cname) {
+			FillMemberTable<T>::exec(tab,cname);
+			std::size_t id = MemberId<H,T>::id();
+			if (tab.members.size()<=id) tab.members.resize(id+1);
+			if (tab.members[id].load)
+				throw streamexception(std::string("Streaming Error: two members of ")+cname+" with id "+T2str(id));
+			tab.members[id].load = &MemberTable<O,S>::template loadone<H>;
+			tab.members[id].name = &MemberTable<O,S>::template nameone<H>;
+		}
+	};
+
 	// Load all of list L on object O
 	template<typename L>
 	struct LoadList {
+		template<typename O, typename S>
+		inline static MemberTable<O,S> build(const char *cname) {
+			MemberTable<O,S> tab;
+			FillMemberTable<L>::exec(tab,cname);
+			return tab;
+		}
+
+		// (made once, as a static initialized by build, so threads
+		// loading at the same time do not race to fill it)
+		template<typename O, typename S>
+		inline static const MemberTable<O,S> &table(const char *cname) {
+			static const MemberTable<O,S> tab = build<O,S>(cname);
+			return tab;
+		}
+
 		template<typename O, typename S>
 		inline static void exec(O o, S &is, const char *cname) {
 			XMLTagInfo info;
@@ -1641,7 +2138,16 @@ namespace XMLSERIALNAMESPACE {
 						throw streamexception(std::string("Stream Input Format Error: not all fields present for ")+cname);
 					return;
 				}
-				if (LoadOne<L>::exec(o,is,info))
+				std::map<std::string,std::string>::const_iterator mi
+					= info.attr.find("mid");
+				if (mi!=info.attr.end()) {
+					const MemberTable<O,S> &tab = table<O,S>(cname);
+					std::size_t id = strtoul(mi->second.c_str(),0,10);
+					if (id>=tab.members.size() || !tab.members[id].load)
+						throw streamexception(std::string("Extra field with id ")+mi->second+" of type "+info.name+" in object "+cname);
+					tab.members[id].load(o,is,info);
+					loadedmem.insert(tab.members[id].name(o));
+				} else if (LoadOne<L>::exec(o,is,info))
 					loadedmem.insert(info.attr["name"]);
 				else
 					throw streamexception(std::string("Extra field ")+info.attr["name"]+" of type "+info.name+" in object "+cname);
@@ -1650,7 +2156,62 @@ namespace XMLSERIALNAMESPACE {
 	};
 
 
+	// the type name of a member, for the schema
+	template<typename T,typename Condition=void>
+	struct MemberTypeName {
+		inline static const char *namestr() { return TypeInfo<T>::namestr(); }
+	};
+
+	template<typename T>
+	struct MemberTypeName<T,typename Type_If<PtrInfo<T>::isptr,void>::type> {
+		inline static const char *namestr() {
+			return TypeInfo<typename PtrInfo<T>::BaseType>::namestr();
+		}
+	};
+
+	template<typename L>
+	struct SchemaItt {
+		template<typename O, typename S>
+		inline static void exec(O, S &) { }
+	};
+
+	template<typename H, typename T>
+	struct SchemaItt<List<H,T> > {
+		template<typename O, typename S>
+		inline static void exec(O o, S &os) {
+			SchemaItt<T>::exec(o,os);
+			XMLTagInfo fields;
+			fields.name = "member";
+			fields.isstart = fields.isend = true;
+			fields.attr["mid"] = T2str(MemberId<H,T>::id());
+			fields.attr["name"] = H::getname(o);
+			fields.attr["type"] = MemberTypeName<typename H::valtype>::namestr();
+			fields.write(os,1);
+		}
+	};
+
+	// writes the id, name, and type of each member of class T (for
+	// tools reading streams saved with memberids)
+	template<typename T, typename S>
+	void SaveSchema(S &os) {
+		XMLTagInfo fields;
+		fields.name = "schema";
+		fields.isstart = true;
+		fields.isend = false;
+		fields.attr["class"] = TypeInfo<T>::namestr();
+		fields.write(os,0);
+		os << '\n';
+		SchemaItt<typename T::xmlserial_alllist>::exec((const T *)0,os);
+		fields.isstart = false;
+		fields.isend = true;
+		fields.write(os,0);
+	}
+
 }
+
+#include "xmlserial_clone.h"
+#include "xmlserial_hash.h"
+
 #undef XMLSERIAL_DECVAL
 /*
 #undef XMLSERIAL_GETTERCOMMON
@@ -33,14 +33,34 @@
 #include <fstream>
 #include <map>
 #include <vector>
+#include <string>
 
 namespace XMLSERIALNAMESPACE {
 
+class archive;
+
+// the pointers shared by several archives, each a shard of one whole (see
+// xmlserial_shard.h)
+class ptrregistry {
+public:
+	virtual ~ptrregistry() {}
+	// the shard that saves the object at p, and its id there:  shard
+	// (with id) if none has yet
+	virtual std::pair<int,int> claim(void *p, int shard, int id) = 0;
+	// the pointer at ptr is to be set later (by set) to object id of
+	// shard
+	virtual void defer(void *ptr, bool (*set)(void *, const archive &, int),
+			int shard, int id, const char *name) = 0;
+};
+
 class archive {
 public:
-	archive(std::istream &input) : is(&input), os(0) {}
-	archive(std::ostream &output) : os(&output), is(0) {}
-	archive(std::iostream &stream) : is(&stream), os(&stream) {}
+	archive(std::istream &input) : is(&input), os(0), strmin(0),
+			reg(0), me(-1), ref(-1) {}
+	archive(std::ostream &output) : is(0), os(&output), strmin(0),
+			reg(0), me(-1), ref(-1) {}
+	archive(std::iostream &stream) : is(&stream), os(&stream), strmin(0),
+			reg(0), me(-1), ref(-1) {}
 
 	//operator std::istream &() { return *is; }
 	//operator std::ostream &() { return *os; }
@@ -69,6 +89,35 @@ public:
 	bool fail() const { return is ? is->fail() : os->fail(); }
 	archive &unget() { if (is) is->unget(); return *this; }
 
+	archive &read(char *s, std::streamsize n) {
+		if (is) is->read(s,n);
+		return *this;
+	}
+	archive &get(char *s, std::streamsize n, char delim) {
+		if (is) is->get(s,n,delim);
+		return *this;
+	}
+	std::streamsize gcount() const { return is ? is->gcount() : 0; }
+	std::ios_base::iostate rdstate() const {
+		return is ? is->rdstate() : os->rdstate();
+	}
+	void clear(std::ios_base::iostate st = std::ios_base::goodbit) {
+		if (is) is->clear(st);
+		else os->clear(st);
+	}
+	archive &write(const char *s, std::streamsize n) {
+		if (os) os->write(s,n);
+		return *this;
+	}
+
+	long &iword(int i) { return is ? is->iword(i) : os->iword(i); }
+	void *&pword(int i) { return is ? is->pword(i) : os->pword(i); }
+	std::streambuf *rdbuf() const { return is ? is->rdbuf() : os->rdbuf(); }
+
+	bool good() const { return is ? is->good() : os->good(); }
+	std::streampos tellg() { return is ? is->tellg() : std::streampos(-1); }
+	std::streampos tellp() { return os ? os->tellp() : std::streampos(-1); }
+
 	std::ios_base::fmtflags flags() const {
 		return is ? is->flags() : os->flags();
 	}
@@ -98,19 +147,21 @@ public:
 	}
 
 	bool validid(int id) const {
-		return id>=0 && id < id2ptr.size();
+		return id>=0 && std::size_t(id) < id2ptr.size();
 	}
 
 	template<typename T>
 	bool lookupptr(int id, T &ptr) const {
-		if (id2ptr.size()<=id) return false;
+		if (!validid(id)) return false;
+		XMLSERIAL_COUNT(ptrcache_hits,1);
 		return PtrInfo<T>::setfrom(ptr,id2ptr[id].first,
 						id2ptr[id].second);
 	}
 
 	template<typename T>
 	bool addptr(int id, const T &ptr) {
-		if (id != id2ptr.size()) return false;
+		if (id<0 || std::size_t(id) != id2ptr.size()) return false;
+		XMLSERIAL_COUNT(ptrcache_misses,1);
 		const char *name = PtrInfo<T>::name();
 		id2ptr.push_back(std::make_pair((void*)(&ptr),name));
 		void *p = PtrInfo<T>::getptr(ptr);
@@ -118,24 +169,99 @@ public:
 		return true;
 	}
 
-	// returns true if already saved
+	// returns true if already saved (here or, for a shard, in the shard
+	// refshard() then returns)
 	template<typename T>
 	bool findoradd(const T &ptr, int &id) {
 		void *p = PtrInfo<T>::getptr(ptr);
 		ptr2idT::iterator loc = ptr2id.lower_bound(p);
+		ref = -1;
 		if (loc==ptr2id.end() || loc->first!=p) {
+			if (reg && claimedelsewhere(p,id)) {
+				XMLSERIAL_COUNT(ptrcache_hits,1);
+				return true;
+			}
+			XMLSERIAL_COUNT(ptrcache_misses,1);
 			id = id2ptr.size();
 			const char *name = PtrInfo<T>::name();
 			id2ptr.push_back(std::make_pair((void*)(&ptr),name));
 			ptr2id.insert(loc,std::make_pair(p,std::make_pair(id,name)));
 			return false;
 		} else {
+			XMLSERIAL_COUNT(ptrcache_hits,1);
 			id = loc->second.first;
 			return true;
 		}
 	}
 
+	// when saving, write strings of at least minlen characters only
+	// once, and later copies as references to the first (0 turns this
+	// off, the default).  Loading handles references regardless.
+	void strtable(std::size_t minlen) { strmin = minlen; }
+
+	// returns true if already saved (id is -1 if s is not to be
+	// put in the table)
+	bool findoraddstr(const std::string &s, int &id) {
+		if (strmin==0 || s.length()<strmin) {
+			id = -1;
+			return false;
+		}
+		std::pair<str2idT::iterator,bool> loc
+			= str2id.insert(std::make_pair(s,(int)str2id.size()));
+		id = loc.first->second;
+		return !loc.second;
+	}
+
+	bool addstr(int id, const std::string &s) {
+		if (id<0 || std::size_t(id) != id2str.size()) return false;
+		id2str.push_back(s);
+		return true;
+	}
+
+	bool lookupstr(int id, std::string &s) const {
+		if (id<0 || id2str.size()<=std::size_t(id)) return false;
+		s = id2str[id];
+		return true;
+	}
+
+	// makes this archive shard number shard of those sharing r
+	void setshard(ptrregistry *r, int shard) {
+		reg = r;
+		me = shard;
+	}
+	bool isshard() const { return reg!=0; }
+	int shardno() const { return me; }
+	// the shard of the pointer findoradd last found (-1 if this one)
+	int refshard() const { return ref; }
+
+	// (loading) ptr is to be set to object id of shard, once it is
+	// loaded
+	template<typename T>
+	void deferptr(T &ptr, int shard, int id) {
+		PtrInfo<T>::setnull(ptr);
+		reg->defer(&ptr,&setptr<T>,shard,id,PtrInfo<T>::name());
+	}
+
 private:
+	// (for a shard) returns true if another shard saves p, setting id
+	// and ref, and otherwise claims p for this one
+	bool claimedelsewhere(void *p, int &id) {
+		foreignT::iterator f = foreign.find(p);
+		if (f==foreign.end()) {
+			std::pair<int,int> o = reg->claim(p,me,id2ptr.size());
+			if (o.first==me) return false;
+			f = foreign.insert(std::make_pair(p,o)).first;
+		}
+		ref = f->second.first;
+		id = f->second.second;
+		return true;
+	}
+
+	template<typename T>
+	static bool setptr(void *ptr, const archive &a, int id) {
+		return a.lookupptr(id,*static_cast<T *>(ptr));
+	}
+
 	std::istream *is;
 	std::ostream *os;
 
@@ -147,18 +273,31 @@ private:
 		
 	ptr2idT ptr2id;
 	id2ptrT id2ptr;
+
+	typedef std::map<std::string,int> str2idT;
+	std::size_t strmin;
+	str2idT str2id;
+	std::vector<std::string> id2str;
+
+	ptrregistry *reg;
+	int me, ref;
+	// (for a shard) the objects other shards save -> shard and id
+	typedef std::map<void*,std::pair<int,int> > foreignT;
+	foreignT foreign;
 };
 
 template<typename T>
 struct ArchiveInfo {
 	XMLSERIAL_DECVAL(isarchive,false);
 	XMLSERIAL_DECVAL(hasptrcache,false);
+	XMLSERIAL_DECVAL(hasstrtable,false);
 };
 
 template<>
 struct ArchiveInfo<XMLSERIALNAMESPACE::archive> {
 	XMLSERIAL_DECVAL(isarchive,true);
 	XMLSERIAL_DECVAL(hasptrcache,true);
+	XMLSERIAL_DECVAL(hasstrtable,true);
 };
 
 }
@@ -32,23 +32,42 @@
 #include <array>
 #include <sstream>
 #include "xmlserial.h"
+#include "xmlserial_bulk.h"
 
 namespace XMLSERIALNAMESPACE {
+	// std::array of numbers (or of such arrays) holds just its elements
+	template<typename T,std::size_t N>
+	struct BulkLayout<std::array<T,N>,
+			typename Type_If<BulkLayout<T>::value
+				&& sizeof(std::array<T,N>)==N*sizeof(T),void>::type> {
+		enum { value = true };
+		typedef typename BulkLayout<T>::scalar scalar;
+		static const std::size_t count = N*BulkLayout<T>::count;
+	};
+
 	// if T is not "shiftable"
 	template<typename T,std::size_t N>
 	struct TypeInfo<std::array<T,N>,
 	typename Type_If<!IsShiftable<T>::atall,void>::type> {
 		inline static const char *namestr() { return "array"; }
 		template<typename S>
-		inline static void addotherattr(XMLTagInfo &fields, const std::array<T,N> &v, S &os) { }
+		inline static void addotherattr(XMLTagInfo &fields, const std::array<T,N> &v, S &os) {
+			if (BulkArrayIO<T>::active(os)) fields.attr["enc"] = "b64";
+		}
 		inline static bool isshort(const std::array<T,N> &) { return false; }
 		inline static bool isinline(const std::array<T,N> &) { return false; }
 		template<typename S>
 		inline static void save(const std::array<T,N> &a,
 				S &os,int indent) {
-			os << std::endl;
+			// arrays of arrays of numbers are written as one run
+			if (BulkArrayIO<T>::active(os)) {
+				BulkArrayIO<T>::save(a.data(),N,os);
+				return;
+			}
+			os << '\n';
 			for(typename std::array<T,N>::const_iterator i=a.begin();
 					i!=a.end();++i) {
+				XMLSERIAL_OBSERVE_SAVE(S,namestr(),"",os);
 				XMLTagInfo fields;
 				SaveWrapper(*i,fields,os,indent+1);
 			}
@@ -57,8 +76,13 @@ namespace XMLSERIALNAMESPACE {
 		template<typename S>
 		inline static void load(std::array<T,N> &a, const XMLTagInfo &info,
 				S &is) {
+			if (IsB64(info)) {
+				BulkArrayIO<T>::load(a.data(),N,is);
+				ReadEndTag(is,namestr());
+				return;
+			}
 			XMLTagInfo eleminfo;
-			int i=0;
+			std::size_t i=0;
 			while(1) {
 				ReadTag(is,eleminfo);
 				if (eleminfo.isend && !eleminfo.isstart) {
@@ -68,6 +92,8 @@ namespace XMLSERIALNAMESPACE {
 					}
 					throw streamexception(std::string("Stream Input Format Error: expected end tag for ")+namestr()+", received end tag for "+eleminfo.name);
 				}
+				if (i==N) throw streamexception(std::string("Stream Input Format Error: expected ")+T2str(N)+" elements in array, received more");
+				XMLSERIAL_OBSERVE_LOAD(S,namestr(),"",is);
 				LoadWrapper(a[i++],eleminfo,is);
 			}
 		}
@@ -83,20 +109,27 @@ namespace XMLSERIALNAMESPACE {
 		}
 		template<typename S>
 		inline static void addotherattr(XMLTagInfo &fields, const std::array<T,N> &a, S &os) {
+			if (BulkIO<T>::active(os)) fields.attr["enc"] = "b64";
 		}
 		inline static bool isshort(const std::array<T,N> &) { return false; }
 		inline static bool isinline(const std::array<T,N> &) { return false; }
 		template<typename S>
 		inline static void save(const std::array<T,N> &a,
 				S &os, int indent) {
-			for(typename std::array<T,N>::const_iterator i=a.begin();i!=a.end();++i)
-				os << *i << ' ';
+			if (BulkIO<T>::active(os)) {
+				BulkIO<T>::save(a.data(),N,os);
+				return;
+			}
+			for(typename std::array<T,N>::const_iterator i=a.begin();i!=a.end();++i) {
+				WriteNum(os,*i);
+				os << ' ';
+			}
 		}
 		template<typename S>
 		inline static void load(std::array<T,N> &a, const XMLTagInfo &info,
 				S &is) {
-			for(int i=0;i<N;i++)
-				is >> a[i];
+			if (IsB64(info)) BulkIO<T>::load(a.data(),N,is);
+			else TextIO<T>::load(a.begin(),N,is);
 			ReadEndTag(is,namestr());
 		}
 	};
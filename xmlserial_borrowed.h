@@ -0,0 +1,242 @@
+/* By Christian R. Shelton
+ * (christian.r.shelton@gmail.com)
+ * August 2014
+ *   [original release]
+ *
+ * Released under MIT software licence:
+ * The MIT License (MIT)
+ * Copyright (c) 2014 Christian R. Shelton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef XMLSERIAL_BORROWED_H
+#define XMLSERIAL_BORROWED_H
+
+#include <streambuf>
+#include <string>
+#include <deque>
+#include <cstring>
+#include <climits>
+#include "xmlserial.h"
+#include "xmlserial_string.h"
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+// Loading strings without copying them.
+//
+// A membuffer is a streambuf that reads from memory already holding the
+// whole input (a file mapped into memory, for instance).  A
+// borrowed_string loaded from a stream (or an archive) reading from a
+// membuffer points straight into that memory if its text has no escapes.
+// Otherwise (and for short strings, which are stored in the tag's value
+// attribute) the decoded text is kept in the membuffer's arena.
+//
+// Lifetime:  a borrowed_string loaded this way is valid only as long as
+// both the memory given to the membuffer and the membuffer itself.
+// Anything loaded holding borrowed_strings must be discarded (or copied
+// to std::strings) before either goes away.
+//
+// Through an archive, strings written once and then referred to (see
+// archive::strtable) load too:  the references are kept in the arena.
+//
+// Loading a borrowed_string from any other stream throws.  Saving is the
+// same as for std::string, so either can be loaded from the other.
+
+namespace XMLSERIALNAMESPACE {
+
+	class membuffer : public std::streambuf {
+	public:
+		membuffer(const char *b, std::size_t n) { reset(b,b+n); }
+		membuffer(const char *b, const char *e) { reset(b,e); }
+
+		// the unread input
+		const char *pos() const { return gptr(); }
+		const char *limit() const { return egptr(); }
+		void skip(std::size_t n) {
+			for(;n>INT_MAX;n-=INT_MAX) gbump(INT_MAX);
+			gbump((int)n);
+		}
+
+		// keeps s (its contents are taken) until the membuffer is
+		// destroyed, returning where
+		const char *keep(std::string &s) {
+			arena.push_back(std::string());
+			arena.back().swap(s);
+			return arena.back().data();
+		}
+
+	protected:
+		// (so that tellg and seekg work, for the positions that stats,
+		// profiles and observers report)
+		pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+				std::ios_base::openmode which = std::ios_base::in) {
+			if (!(which & std::ios_base::in)) return pos_type(off_type(-1));
+			const char *from = dir==std::ios_base::beg ? eback()
+				: dir==std::ios_base::cur ? gptr() : egptr();
+			off_type at = (from-eback())+off;
+			if (at<0 || at>egptr()-eback()) return pos_type(off_type(-1));
+			setg(eback(),eback()+at,egptr());
+			return pos_type(at);
+		}
+		pos_type seekpos(pos_type p,
+				std::ios_base::openmode which = std::ios_base::in) {
+			return seekoff(off_type(p),std::ios_base::beg,which);
+		}
+
+	private:
+		void reset(const char *b, const char *e) {
+			char *p = const_cast<char *>(b);
+			setg(p,p,const_cast<char *>(e));
+		}
+
+		// (a deque does not move its elements as it grows)
+		std::deque<std::string> arena;
+	};
+
+	class borrowed_string {
+	public:
+		borrowed_string() : p(""), n(0) {}
+		borrowed_string(const char *s, std::size_t len) : p(s), n(len) {}
+
+		const char *data() const { return p; }
+		std::size_t size() const { return n; }
+		std::size_t length() const { return n; }
+		bool empty() const { return n==0; }
+		const char *begin() const { return p; }
+		const char *end() const { return p+n; }
+		char operator[](std::size_t i) const { return p[i]; }
+
+		std::string str() const { return std::string(p,n); }
+#if __cplusplus >= 201703L
+		operator std::string_view() const { return std::string_view(p,n); }
+#endif
+
+		bool operator==(const borrowed_string &s) const {
+			return n==s.n && !memcmp(p,s.p,n);
+		}
+		bool operator!=(const borrowed_string &s) const {
+			return !(*this==s);
+		}
+		bool operator<(const borrowed_string &s) const {
+			int c = memcmp(p,s.p,n<s.n ? n : s.n);
+			return c<0 || (c==0 && n<s.n);
+		}
+
+	private:
+		const char *p;
+		std::size_t n;
+	};
+
+	inline std::ostream &operator<<(std::ostream &os, const borrowed_string &s) {
+		return os.write(s.data(),s.size());
+	}
+
+	// sets p and n to the string for the tag just read (info)
+	template<typename S>
+	inline void LoadBorrowed(const char *&p, std::size_t &n,
+				const XMLTagInfo &info, S &is) {
+		XMLSERIAL_COUNT(strings_read,1);
+		membuffer *mb = dynamic_cast<membuffer *>(is.rdbuf());
+		if (!mb)
+			throw streamexception("Stream Input Format Error: borrowed strings can only be loaded from a membuffer");
+		if (!info.isend && info.attr.find("value")==info.attr.end()
+				&& info.attr.find("enc")==info.attr.end()) {
+			const char *b = mb->pos(), *e = mb->limit();
+			const char *lt = (const char *)memchr(b,'<',e-b);
+			if (lt && !memchr(b,'\\',lt-b) && !memchr(b,'&',lt-b)) {
+				p = b;
+				n = lt-b;
+				mb->skip(n);
+				ReadEndTag(is,TypeInfo<std::string>::namestr());
+				// (a string an archive's later references (sref) name)
+				std::map<std::string,std::string>::const_iterator ii
+					= info.attr.find("sid");
+				if (ii!=info.attr.end())
+					StrTable<S>::add(is,atoi(ii->second.c_str()),
+						std::string(p,n));
+				return;
+			}
+		}
+		std::string s;
+		TypeInfo<std::string>::load(s,info,is);
+		n = s.length();
+		p = mb->keep(s);
+	}
+
+	template<>
+	struct TypeInfo<borrowed_string,void> {
+		inline static const char *namestr() { return "string"; }
+		template<typename S>
+		inline static void addotherattr(XMLTagInfo &fields,
+				const borrowed_string &s, S &os) {
+			if (!isshort(s)) fields.attr["len"] = T2str(s.length());
+		}
+		// (as for std::string, a NUL keeps the string out of the value)
+		inline static bool isshort(const borrowed_string &s) {
+			return s.length()<20 && !memchr(s.begin(),0,s.length());
+		}
+		inline static bool isinline(const borrowed_string &s) { return false; }
+		template<typename S>
+		inline static void save(const borrowed_string &s, S &os,
+				int indent) {
+			WriteStr(os,s.begin(),s.end(),isshort(s));
+		}
+		template<typename S>
+		inline static void load(borrowed_string &s, const XMLTagInfo &info,
+				S &is) {
+			const char *p;
+			std::size_t n;
+			LoadBorrowed(p,n,info,is);
+			s = borrowed_string(p,n);
+		}
+	};
+
+#if __cplusplus >= 201703L
+	template<>
+	struct TypeInfo<std::string_view,void> {
+		inline static const char *namestr() { return "string"; }
+		template<typename S>
+		inline static void addotherattr(XMLTagInfo &fields,
+				const std::string_view &s, S &os) {
+			if (!isshort(s)) fields.attr["len"] = T2str(s.length());
+		}
+		inline static bool isshort(const std::string_view &s) {
+			return s.length()<20 && !memchr(s.data(),0,s.length());
+		}
+		inline static bool isinline(const std::string_view &s) { return false; }
+		template<typename S>
+		inline static void save(const std::string_view &s, S &os,
+				int indent) {
+			WriteStr(os,s.data(),s.data()+s.length(),isshort(s));
+		}
+		template<typename S>
+		inline static void load(std::string_view &s, const XMLTagInfo &info,
+				S &is) {
+			const char *p;
+			std::size_t n;
+			LoadBorrowed(p,n,info,is);
+			s = std::string_view(p,n);
+		}
+	};
+#endif
+
+}
+#endif
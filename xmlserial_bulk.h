@@ -0,0 +1,578 @@
+/* By Christian R. Shelton
+ * (christian.r.shelton@gmail.com)
+ * August 2014
+ *   [original release]
+ *
+ * Released under MIT software licence:
+ * The MIT License (MIT)
+ * Copyright (c) 2014 Christian R. Shelton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef XMLSERIAL_BULK_H
+#define XMLSERIAL_BULK_H
+
+#include <iterator>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <locale>
+#include <vector>
+#include "xmlserial.h"
+
+// Loading and saving of arrays of numbers in bulk.
+//
+// Raw byte ("bulk") encoding:  Turned on for a stream (or an archive)
+// with the bulkarrays manipulator.  The elements are written as their
+// little-endian bytes in base64 and the tag is given the attribute
+// enc="b64".  Loading recognizes the attribute no matter how the stream
+// is set.
+//
+// Text encoding:  The usual space-separated list.  Loading reads the
+// whole run of text in blocks and converts the numbers in place, rather
+// than calling >> for each element.
+
+namespace XMLSERIALNAMESPACE {
+
+	// can T be written as its raw bytes?
+	template<typename T>
+	struct IsBulk {
+		enum { value = false };
+	};
+
+#define XMLSERIAL_BULKTYPE(tname) \
+	template<> \
+	struct IsBulk<tname> { \
+		enum { value = true }; \
+	};
+
+	XMLSERIAL_BULKTYPE(char)
+	XMLSERIAL_BULKTYPE(signed char)
+	XMLSERIAL_BULKTYPE(unsigned char)
+	XMLSERIAL_BULKTYPE(short)
+	XMLSERIAL_BULKTYPE(unsigned short)
+	XMLSERIAL_BULKTYPE(int)
+	XMLSERIAL_BULKTYPE(unsigned int)
+	XMLSERIAL_BULKTYPE(long)
+	XMLSERIAL_BULKTYPE(unsigned long)
+	XMLSERIAL_BULKTYPE(float)
+	XMLSERIAL_BULKTYPE(double)
+#if __cplusplus > 199711L
+	XMLSERIAL_BULKTYPE(long long)
+	XMLSERIAL_BULKTYPE(unsigned long long)
+#endif
+	// (not bool, whose size is not fixed, or long double, whose
+	//  layout is not)
+
+#undef XMLSERIAL_BULKTYPE
+
+	inline bool HostIsLittleEndian() {
+		const unsigned int one = 1;
+		return *reinterpret_cast<const unsigned char *>(&one) == 1;
+	}
+
+	inline const char *B64Chars() {
+		return "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	}
+
+	// inverse of B64Chars (-1 for characters not in the alphabet); a
+	// constant table, so it is ready before any thread uses it
+	inline const signed char *B64Values() {
+		static const signed char table[256] = {
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+			52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+			-1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+			15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+			-1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+			41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+		};
+		return table;
+	}
+
+	inline std::size_t B64Len(std::size_t nbytes) {
+		return 4*((nbytes+2)/3);
+	}
+
+	// encodes n bytes from in to out (which must have room for B64Len(n))
+	inline void B64Encode(const unsigned char *in, std::size_t n, char *out) {
+		const char *c = B64Chars();
+		std::size_t i=0;
+		for(;i+3<=n;i+=3,out+=4) {
+			unsigned int w = (in[i]<<16) | (in[i+1]<<8) | in[i+2];
+			out[0] = c[(w>>18)&63];
+			out[1] = c[(w>>12)&63];
+			out[2] = c[(w>>6)&63];
+			out[3] = c[w&63];
+		}
+		if (i<n) {
+			unsigned int w = in[i]<<16;
+			if (i+1<n) w |= in[i+1]<<8;
+			out[0] = c[(w>>18)&63];
+			out[1] = c[(w>>12)&63];
+			out[2] = i+1<n ? c[(w>>6)&63] : '=';
+			out[3] = '=';
+		}
+	}
+
+	// decodes nchar characters (a multiple of 4) from in to out
+	// returns the number of bytes written (-1 on a malformed input)
+	inline long B64Decode(const char *in, std::size_t nchar,
+				unsigned char *out) {
+		const signed char *v = B64Values();
+		long ret = 0;
+		for(std::size_t i=0;i<nchar;i+=4) {
+			int a = v[(unsigned char)in[i]], b = v[(unsigned char)in[i+1]];
+			if (a<0 || b<0) return -1;
+			out[ret++] = (unsigned char)((a<<2) | (b>>4));
+			if (in[i+2]=='=') {
+				if (in[i+3]!='=' || i+4!=nchar) return -1;
+				break;
+			}
+			int c = v[(unsigned char)in[i+2]];
+			if (c<0) return -1;
+			out[ret++] = (unsigned char)((b<<4) | (c>>2));
+			if (in[i+3]=='=') {
+				if (i+4!=nchar) return -1;
+				break;
+			}
+			int d = v[(unsigned char)in[i+3]];
+			if (d<0) return -1;
+			out[ret++] = (unsigned char)((c<<6) | d);
+		}
+		return ret;
+	}
+
+	// copies the bytes of one element in little-endian order
+	inline void LECopy(unsigned char *dst, const unsigned char *src,
+				std::size_t n, bool little) {
+		if (little) memcpy(dst,src,n);
+		else for(std::size_t i=0;i<n;i++) dst[i] = src[n-1-i];
+	}
+
+	// was this tag saved with a bulk encoding?
+	inline bool IsB64(const XMLTagInfo &info) {
+		std::map<std::string,std::string>::const_iterator ei
+			= info.attr.find("enc");
+		if (ei==info.attr.end()) return false;
+		if (ei->second!="b64")
+			throw streamexception(std::string("Stream Input Format Error: unknown encoding ")+ei->second+" for "+info.name);
+		return true;
+	}
+
+	// save/load n elements starting at iterator i, in bulk (if possible)
+	template<typename T,typename Condition=void>
+	struct BulkIO {
+		template<typename S>
+		inline static bool active(S &) { return false; }
+		template<typename I, typename S>
+		inline static void save(I, std::size_t, S &) {
+			throw streamexception("Streaming Error: bulk encoding of a type that is not a number");
+		}
+		template<typename I, typename S>
+		inline static void load(I, std::size_t, S &) {
+			throw streamexception("Stream Input Format Error: bulk encoding of a type that is not a number");
+		}
+	};
+
+	template<typename T>
+	struct BulkIO<T,typename Type_If<IsBulk<T>::value,void>::type> {
+		// bytes per block: a multiple of 3 (for base64) and of sizeof(T)
+		enum { BLOCK = 3*8*256 };
+
+		// (arrays of bytes are also blobs, for blobstrings)
+		template<typename S>
+		inline static bool active(S &os) {
+			return HasEnc(os,sizeof(T)==1 ? ENC_BULKARRAYS|ENC_BLOBSTRINGS
+						: ENC_BULKARRAYS);
+		}
+
+		template<typename I, typename S>
+		inline static void save(I i, std::size_t n, S &os) {
+			const bool little = HostIsLittleEndian();
+			unsigned char in[BLOCK];
+			char out[BLOCK/3*4];
+			std::size_t k = 0;
+			for(;n>0;--n,++i) {
+				const T &t = *i;
+				LECopy(in+k,reinterpret_cast<const unsigned char *>(&t),
+						sizeof(T),little);
+				if ((k+=sizeof(T))==BLOCK) {
+					B64Encode(in,k,out);
+					os.write(out,B64Len(k));
+					k = 0;
+				}
+			}
+			if (k) {
+				B64Encode(in,k,out);
+				os.write(out,B64Len(k));
+			}
+		}
+
+		template<typename I, typename S>
+		inline static void load(I i, std::size_t n, S &is) {
+			const bool little = HostIsLittleEndian();
+			unsigned char out[BLOCK];
+			char in[BLOCK/3*4];
+			std::size_t nbytes = n*sizeof(T);
+			IgnoreWS(is);
+			while(nbytes>0) {
+				std::size_t k = nbytes<BLOCK ? nbytes : std::size_t(BLOCK);
+				std::size_t nchar = B64Len(k);
+				is.read(in,nchar);
+				if (is.fail() || (std::size_t)is.gcount()!=nchar
+						|| B64Decode(in,nchar,out)!=(long)k)
+					throw streamexception("Stream Input Format Error: malformed or short base64 array data");
+				for(std::size_t j=0;j<k;j+=sizeof(T),++i) {
+					T &t = *i;
+					LECopy(reinterpret_cast<unsigned char *>(&t),out+j,
+							sizeof(T),little);
+				}
+				nbytes -= k;
+			}
+		}
+
+		// contiguous elements on a little-endian machine are already
+		// in the right order and are encoded (decoded) in place
+		template<typename S>
+		inline static void save(const T *p, std::size_t n, S &os) {
+			if (!HostIsLittleEndian()) {
+				save<const T *,S>(p,n,os);
+				return;
+			}
+			const unsigned char *in = reinterpret_cast<const unsigned char *>(p);
+			char out[BLOCK/3*4];
+			for(std::size_t nbytes=n*sizeof(T);nbytes>0;) {
+				std::size_t k = nbytes<BLOCK ? nbytes : std::size_t(BLOCK);
+				B64Encode(in,k,out);
+				os.write(out,B64Len(k));
+				in += k;
+				nbytes -= k;
+			}
+		}
+
+		template<typename S>
+		inline static void load(T *p, std::size_t n, S &is) {
+			if (!HostIsLittleEndian()) {
+				load<T *,S>(p,n,is);
+				return;
+			}
+			unsigned char *out = reinterpret_cast<unsigned char *>(p);
+			char in[BLOCK/3*4];
+			IgnoreWS(is);
+			for(std::size_t nbytes=n*sizeof(T);nbytes>0;) {
+				std::size_t k = nbytes<BLOCK ? nbytes : std::size_t(BLOCK);
+				std::size_t nchar = B64Len(k);
+				is.read(in,nchar);
+				if (is.fail() || (std::size_t)is.gcount()!=nchar
+						|| B64Decode(in,nchar,out)!=(long)k)
+					throw streamexception("Stream Input Format Error: malformed or short base64 array data");
+				out += k;
+				nbytes -= k;
+			}
+		}
+	};
+
+	// the layout of arrays (of arrays...) of numbers: count scalars, one
+	// after the other
+	template<typename T,typename Condition=void>
+	struct BulkLayout {
+		enum { value = false };
+	};
+
+	template<typename T>
+	struct BulkLayout<T,typename Type_If<IsBulk<T>::value,void>::type> {
+		enum { value = true };
+		typedef T scalar;
+		static const std::size_t count = 1;
+	};
+
+	template<typename T,std::size_t N>
+	struct BulkLayout<T[N],typename Type_If<BulkLayout<T>::value,void>::type> {
+		enum { value = true };
+		typedef typename BulkLayout<T>::scalar scalar;
+		static const std::size_t count = N*BulkLayout<T>::count;
+	};
+
+	// save/load n elements (of type E) starting at p, as a single run
+	// of numbers if E is laid out as above
+	template<typename E,typename Condition=void>
+	struct BulkArrayIO {
+		template<typename S>
+		inline static bool active(S &) { return false; }
+		template<typename S>
+		inline static void save(const E *, std::size_t, S &) {
+			throw streamexception("Streaming Error: bulk encoding of an array that is not of numbers");
+		}
+		template<typename S>
+		inline static void load(E *, std::size_t, S &) {
+			throw streamexception("Stream Input Format Error: bulk encoding of an array that is not of numbers");
+		}
+	};
+
+	template<typename E>
+	struct BulkArrayIO<E,typename Type_If<BulkLayout<E>::value,void>::type> {
+		typedef typename BulkLayout<E>::scalar scalar;
+		template<typename S>
+		inline static bool active(S &os) {
+			return BulkIO<scalar>::active(os);
+		}
+		template<typename S>
+		inline static void save(const E *p, std::size_t n, S &os) {
+			BulkIO<scalar>::save(reinterpret_cast<const scalar *>(p),
+					n*BulkLayout<E>::count,os);
+		}
+		template<typename S>
+		inline static void load(E *p, std::size_t n, S &is) {
+			BulkIO<scalar>::load(reinterpret_cast<scalar *>(p),
+					n*BulkLayout<E>::count,is);
+		}
+	};
+
+
+	// numbers that >> reads as text (that is, not the char types)
+	template<typename T>
+	struct IsTextNum {
+		enum { value = IsBulk<T>::value && sizeof(T)>1 };
+	};
+
+#if __cplusplus > 199711L
+	typedef unsigned long long textumax;
+#else
+	typedef unsigned long textumax;
+#endif
+
+	// conversion of one token [s,e) of text to a number
+	// (false if the token is not a number of type T)
+	template<typename T>
+	inline typename Type_If<std::numeric_limits<T>::is_integer,bool>::type
+	ParseNum(const char *s, const char *e, T &t) {
+		bool neg = false;
+		if (*s=='-' || *s=='+') neg = *s++=='-';
+		if (s==e) return false;
+		const textumax lim = neg
+			? (textumax)0-(textumax)std::numeric_limits<T>::min()
+			: (textumax)std::numeric_limits<T>::max();
+		const textumax q = lim/10, r = lim%10;
+		textumax v = 0;
+		for(;s<e;++s) {
+			unsigned int d = (unsigned char)*s - '0';
+			if (d>9 || v>q || (v==q && d>r)) return false;
+			v = v*10+d;
+		}
+		if (!neg || v==0) t = (T)v;
+		else t = -(T)(v-1)-1;
+		return true;
+	}
+
+	// is [s,e) a number in the decimal form >> reads (so not inf, nan or
+	// hexadecimal, which strtod and from_chars also take)?
+	inline bool IsDecimalNum(const char *s, const char *e) {
+		if (s<e && (*s=='-' || *s=='+')) ++s;
+		const char *b = s;
+		while(s<e && *s>='0' && *s<='9') ++s;
+		bool whole = s>b;
+		if (s<e && *s=='.') {
+			b = ++s;
+			while(s<e && *s>='0' && *s<='9') ++s;
+			if (!whole && s==b) return false;
+		} else if (!whole) return false;
+		if (s<e && (*s=='e' || *s=='E')) {
+			++s;
+			if (s<e && (*s=='-' || *s=='+')) ++s;
+			b = s;
+			while(s<e && *s>='0' && *s<='9') ++s;
+			if (s==b) return false;
+		}
+		return s==e;
+	}
+
+#ifdef XMLSERIAL_TO_CHARS
+	// from_chars does not depend on any locale
+	inline bool FloatsNeedStream() { return false; }
+
+	template<typename F>
+	inline bool ParseFloat(const char *s, const char *e, F &t) {
+		if (!IsDecimalNum(s,e)) return false;
+		if (*s=='+') ++s;
+		std::from_chars_result r
+			= std::from_chars(s,e,t,std::chars_format::general);
+		return r.ec==std::errc() && r.ptr==e;
+	}
+
+	inline bool ParseNum(const char *s, const char *e, double &t) {
+		return ParseFloat(s,e,t);
+	}
+
+	inline bool ParseNum(const char *s, const char *e, float &t) {
+		return ParseFloat(s,e,t);
+	}
+#else
+	// strtod reads with the C global locale's decimal point, so it can
+	// only be used if that is .
+	inline bool FloatsNeedStream() { return !CDecimalIsDot(); }
+
+	inline bool ParseNum(const char *s, const char *e, double &t) {
+		if (!IsDecimalNum(s,e)) return false;
+		char *end;
+		t = strtod(s,&end);
+		return end==e;
+	}
+
+	inline bool ParseNum(const char *s, const char *e, float &t) {
+		if (!IsDecimalNum(s,e)) return false;
+		char *end;
+#if __cplusplus > 199711L
+		t = strtof(s,&end);
+#else
+		t = (float)strtod(s,&end);
+#endif
+		return end==e;
+	}
+#endif
+
+	inline bool IsWS(char c) {
+		return c==' ' || c=='\n' || c=='\t' || c=='\r' || c=='\v' || c=='\f';
+	}
+
+	// splits the text up to the next < into whitespace separated tokens,
+	// reading it from the stream a block at a time
+	template<typename S>
+	class TextScanner {
+	public:
+		// (the text is read a block at a time, into a small buffer on the
+		// stack first, so that short arrays allocate nothing; each block
+		// after that is four times the size, up to BLOCK)
+		enum { SMALL = 256, BLOCK = 1<<16 };
+
+		TextScanner(S &s) : is(s), buf(small), cap(SMALL), filled(false),
+				done(false)
+			{ pos = end = buf; *end = 0; }
+
+		// the next token is [tok,tokend) (and is followed by a space
+		// or a 0); false if there are no more before the <
+		bool next(const char *&tok, const char *&tokend) {
+			while(1) {
+				while(pos<end && IsWS(*pos)) ++pos;
+				char *e = pos;
+				while(e<end && !IsWS(*e)) ++e;
+				if (pos<end && (e<end || done)) {
+					tok = pos; tokend = e;
+					pos = e;
+					return true;
+				}
+				if (done) return false;
+				fill();
+			}
+		}
+
+	private:
+		void fill() {
+			std::size_t keep = end-pos;
+			if (filled && cap<BLOCK) grow(keep);
+			if (keep>=cap)
+				throw streamexception("Stream Input Format Error: token too long in array");
+			memmove(buf,pos,keep);
+			pos = buf;
+			end = pos+keep;
+			std::streamsize want = cap-keep;
+			is.get(end,want+1,'<');
+			std::streamsize got = is.gcount();
+			if (got<want) {
+				done = true;
+				// get fails if the < is immediately next
+				if (got==0 && !(is.rdstate() & std::ios_base::badbit))
+					is.clear(is.rdstate() & ~std::ios_base::failbit);
+			}
+			end += got;
+			*end = 0;
+			filled = true;
+		}
+
+		// moves the keep characters at pos to a larger buffer
+		void grow(std::size_t keep) {
+			std::size_t n = cap*4<std::size_t(BLOCK) ? cap*4 : std::size_t(BLOCK);
+			std::vector<char> nb(n+1);
+			memcpy(&nb[0],pos,keep);
+			heap.swap(nb);
+			buf = pos = &heap[0];
+			end = pos+keep;
+			cap = n;
+		}
+
+		S &is;
+		char small[SMALL+1];
+		std::vector<char> heap;
+		char *buf,*pos,*end;
+		std::size_t cap;
+		bool filled, done;
+	};
+
+	// load n elements (written as text) starting at iterator i
+	template<typename T,typename Condition=void>
+	struct TextIO {
+		template<typename I, typename S>
+		inline static void load(I i, std::size_t n, S &is) {
+			for(;n>0;--n,++i)
+				is >> *i;
+		}
+	};
+
+	template<typename T>
+	struct TextIO<T,typename Type_If<IsTextNum<T>::value,void>::type> {
+		template<typename I, typename S>
+		inline static void load(I i, std::size_t n, S &is) {
+			// anything other than plain decimal in the "C" locale
+			// (the stream's, and for strtod the C library's) is left
+			// to the stream
+			// (TextIO<T,bool> is the general version)
+			if ((is.flags() & std::ios_base::basefield)!=std::ios_base::dec
+					|| !(is.getloc()==std::locale::classic())
+					|| (!std::numeric_limits<T>::is_integer
+						&& FloatsNeedStream())) {
+				TextIO<T,bool>::load(i,n,is);
+				return;
+			}
+			if (n==0) return;
+			TextScanner<S> sc(is);
+			const char *tok,*tokend;
+			for(;n>0;--n,++i) {
+				if (!sc.next(tok,tokend))
+					throw streamexception("Stream Input Format Error: too few elements in array");
+				T &t = *i;
+				if (!ParseNum(tok,tokend,t))
+					throw streamexception(std::string("Stream Input Format Error: bad number ")+std::string(tok,tokend)+" in array");
+			}
+			if (sc.next(tok,tokend))
+				throw streamexception("Stream Input Format Error: too many elements in array");
+		}
+	};
+
+}
+#endif
@@ -31,6 +31,7 @@
 
 #include <sstream>
 #include "xmlserial.h"
+#include "xmlserial_bulk.h"
 
 namespace XMLSERIALNAMESPACE {
 	// if T is not "shiftable"
@@ -38,13 +39,21 @@ namespace XMLSERIALNAMESPACE {
 	struct TypeInfo<T[N],typename Type_If<!IsShiftable<T>::atall,void>::type> {
 		inline static const char *namestr() { return "carray"; }
 		template<typename S>
-		inline static void addotherattr(XMLTagInfo &fields, const T (&v)[N], S &os) { }
+		inline static void addotherattr(XMLTagInfo &fields, const T (&v)[N], S &os) {
+			if (BulkArrayIO<T>::active(os)) fields.attr["enc"] = "b64";
+		}
 		inline static bool isshort(const T (&)[N]) { return false; }
 		inline static bool isinline(const T (&)[N]) { return false; }
 		template<typename S>
 		inline static void save(const T (&a)[N], S &os,int indent) {
-			os << std::endl;
+			// arrays of arrays of numbers are written as one run
+			if (BulkArrayIO<T>::active(os)) {
+				BulkArrayIO<T>::save(&a[0],N,os);
+				return;
+			}
+			os << '\n';
 			for(std::size_t i=0;i<N;i++) {
+				XMLSERIAL_OBSERVE_SAVE(S,namestr(),"",os);
 				XMLTagInfo fields;
 				SaveWrapper(a[i],fields,os,indent+1);
 			}
@@ -52,6 +61,11 @@ namespace XMLSERIALNAMESPACE {
 		}
 		template<typename S>
 		inline static void load(T a[N], const XMLTagInfo &info, S &is) {
+			if (IsB64(info)) {
+				BulkArrayIO<T>::load(&a[0],N,is);
+				ReadEndTag(is,namestr());
+				return;
+			}
 			XMLTagInfo eleminfo;
 			std::size_t i=0;
 			while(1) {
@@ -63,6 +77,8 @@ namespace XMLSERIALNAMESPACE {
 					}
 					throw streamexception(std::string("Stream Input Format Error: expected end tag for ")+namestr()+", received end tag for "+eleminfo.name);
 				}
+				if (i==N) throw streamexception(std::string("Stream Input Format Error: expected ")+T2str(N)+" elements in array, received more");
+				XMLSERIAL_OBSERVE_LOAD(S,namestr(),"",is);
 				LoadWrapper(a[i++],eleminfo,is);
 			}
 		}
@@ -77,18 +93,25 @@ namespace XMLSERIALNAMESPACE {
 		}
 		template<typename S>
 		inline static void addotherattr(XMLTagInfo &fields, const T (&a)[N], S &os) {
+			if (BulkIO<T>::active(os)) fields.attr["enc"] = "b64";
 		}
 		inline static bool isshort(const T (&)[N]) { return false; }
 		inline static bool isinline(const T (&)[N]) { return false; }
 		template<typename S>
 		inline static void save(const T (&a)[N], S &os, int indent) {
-			for(std::size_t i=0;i<N;i++)
-				os << a[i] << ' ';
+			if (BulkIO<T>::active(os)) {
+				BulkIO<T>::save(&a[0],N,os);
+				return;
+			}
+			for(std::size_t i=0;i<N;i++) {
+				WriteNum(os,a[i]);
+				os << ' ';
+			}
 		}
 		template<typename S>
 		inline static void load(T a[N], const XMLTagInfo &info, S &is) {
-			for(std::size_t i=0;i<N;i++)
-				is >> a[i];
+			if (IsB64(info)) BulkIO<T>::load(&a[0],N,is);
+			else TextIO<T>::load(&a[0],N,is);
 			ReadEndTag(is,namestr());
 		}
 	};
@@ -0,0 +1,398 @@
+/* By Christian R. Shelton
+ * (christian.r.shelton@gmail.com)
+ * August 2014
+ *   [original release]
+ *
+ * Released under MIT software licence:
+ * The MIT License (MIT)
+ * Copyright (c) 2014 Christian R. Shelton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef XMLSERIAL_CLONE_H
+#define XMLSERIAL_CLONE_H
+
+#include <map>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <typeinfo>
+#if __cplusplus > 199711L
+#include <array>
+#include <forward_list>
+#endif
+
+// Cloning:  Clone(obj) makes a deep copy of obj by walking the same member
+// lists (and pointers) as Save and Load, but without any text in between.
+//
+// Members not listed in the class's serialization are left as the default
+// constructor sets them (as they would be by a Load), and the presave,
+// postsave, preload, and postload hooks are called as for a save and load.
+// Objects pointed to more than once within one clone are copied once, and
+// the copies point to the same new object.  Derived classes are allocated
+// through the same factories Load uses.  Objects of a subclass of a
+// pointer's type are copied directly if compiled with XMLSERIAL_STRUCTURAL
+// (see xmlserial.h), and otherwise through their text (saved and loaded
+// through an archive on their own, so pointers from within them to the
+// rest of the clone get copies of their own).
+//
+// Types that contain no pointers and no serializable classes (numbers,
+// strings, vectors of numbers, ...) are copied by assignment.
+// Containers without iterators (stack, queue) are also copied by assignment,
+// so pointers inside them are not followed.
+
+namespace XMLSERIALNAMESPACE {
+
+	template<typename T>
+	struct StripConst { typedef T type; };
+	template<typename T>
+	struct StripConst<const T> { typedef T type; };
+
+	// whether T has iterators (and so is copied element by element)
+	template<typename T>
+	struct IsRange {
+		template<typename S> static char
+			(& chk(typename S::const_iterator *))[1];
+		template<typename> static char (& chk(...))[2];
+		enum { value = sizeof(chk<T>(0)) == 1 };
+	};
+
+	// whether T has to be cloned member by member (or element by element)
+	// rather than just assigned
+	template<typename T, typename Condition=void>
+	struct NeedsClone {
+		enum { value = PtrInfo<T>::isptr || TypeProp<T>::HasIDname };
+	};
+
+	template<typename T>
+	struct NeedsClone<T,typename Type_If<IsRange<T>::value,void>::type> {
+		enum { value = TypeProp<T>::HasIDname
+			|| NeedsClone<typename StripConst<typename T::value_type>::type>::value };
+	};
+
+	template<typename A, typename B>
+	struct NeedsClone<std::pair<A,B>,void> {
+		enum { value = NeedsClone<typename StripConst<A>::type>::value
+			|| NeedsClone<typename StripConst<B>::type>::value };
+	};
+
+	template<typename T, std::size_t N>
+	struct NeedsClone<T[N],void> {
+		enum { value = NeedsClone<T>::value };
+	};
+
+	// keeps track of the objects already cloned
+	class cloner {
+	public:
+		cloner() {}
+		~cloner() {
+			for(std::size_t i=0;i<held.size();i++) delete held[i];
+		}
+
+		template<typename T>
+		void operator()(const T &src, T &dst) { CloneWrapper(src,dst,*this); }
+
+		// returns true if the object src points to was already cloned
+		// (dst is then set to point to its clone)
+		template<typename P>
+		bool lookupptr(const P &src, P &dst) const {
+			typedef typename PtrInfo<P>::BaseType BT;
+			ptrmapT::const_iterator loc = ptrmap.find(PtrInfo<P>::getptr(src));
+			if (loc==ptrmap.end()) return false;
+			if (!PtrInfo<P>::setfrom(dst,loc->second.handle,loc->second.name)
+					&& !PtrInfo<P>::setfrom(dst,loc->second.rawhandle,
+						PtrInfo<BT *>::name()))
+				throw streamexception(std::string("Clone Error: pointer cannot be converted (pointed to by another kind of pointer) for type ")+TypeInfo<BT>::namestr());
+			return true;
+		}
+
+		// dst is the (new) clone of the object src points to
+		template<typename P>
+		void addptr(const P &src, const P &dst) {
+			ptrinfo info;
+			info.handle = keep(dst);
+			info.name = PtrInfo<P>::name();
+			info.rawhandle = keep(&PtrInfo<P>::deref_const(dst));
+			ptrmap[PtrInfo<P>::getptr(src)] = info;
+		}
+
+	private:
+		cloner(const cloner &);
+		cloner &operator=(const cloner &);
+
+		// copies of the new pointers, so later pointers can be set from
+		// them (as the archive does with the pointers it has loaded)
+		struct holderbase { virtual ~holderbase() {} };
+		template<typename P>
+		struct holder : public holderbase {
+			holder(const P &pp) : p(pp) {}
+			P p;
+		};
+
+		template<typename P>
+		void *keep(const P &p) {
+			holder<P> *h = new holder<P>(p);
+			held.push_back(h);
+			return &(h->p);
+		}
+		template<typename T>
+		void *keep(const T *p) {
+			holder<T *> *h = new holder<T *>(const_cast<T *>(p));
+			held.push_back(h);
+			return &(h->p);
+		}
+#if __cplusplus > 199711L
+		template<typename T>
+		void *keep(const std::unique_ptr<T> &) { return nullptr; }
+#endif
+
+		// handle is a pointer to a copy of the pointer (named name),
+		// rawhandle to a copy as a plain pointer
+		struct ptrinfo {
+			void *handle, *rawhandle;
+			const char *name;
+		};
+		// void* below is the address of the object pointed to
+		typedef std::map<void *,ptrinfo> ptrmapT;
+		ptrmapT ptrmap;
+		std::vector<holderbase *> held;
+	};
+
+	// the pre/post save and load methods, for classes that have them
+	template<typename T>
+	inline typename Type_If<TypeProp<T>::HasPreSave,void>::type
+	RunPreSave(const T &t) { t.xmlserial_presave(); }
+	template<typename T>
+	inline typename Type_If<!TypeProp<T>::HasPreSave,void>::type
+	RunPreSave(const T &t) { }
+
+	template<typename T>
+	inline typename Type_If<TypeProp<T>::HasPostSave,void>::type
+	RunPostSave(const T &t) { t.xmlserial_postsave(); }
+	template<typename T>
+	inline typename Type_If<!TypeProp<T>::HasPostSave,void>::type
+	RunPostSave(const T &t) { }
+
+	template<typename T>
+	inline typename Type_If<TypeProp<T>::HasPreLoad,void>::type
+	RunPreLoad(T &t) { t.xmlserial_preload(); }
+	template<typename T>
+	inline typename Type_If<!TypeProp<T>::HasPreLoad,void>::type
+	RunPreLoad(T &t) { }
+
+	template<typename T>
+	inline typename Type_If<TypeProp<T>::HasPostLoad,void>::type
+	RunPostLoad(T &t) { t.xmlserial_postload(); }
+	template<typename T>
+	inline typename Type_If<!TypeProp<T>::HasPostLoad,void>::type
+	RunPostLoad(T &t) { }
+
+	// the members of a class, one by one
+	template<typename L>
+	struct CloneItt {
+	};
+
+	template<>
+	struct CloneItt<ListEnd> {
+		template<typename O>
+		inline static void exec(const O *src, O *dst, cloner &c) { }
+	};
+
+	template<typename H, typename T>
+	struct CloneItt<List<H,T> > {
+		template<typename O>
+		inline static void exec(const O *src, O *dst, cloner &c) {
+			CloneItt<T>::exec(src,dst,c);
+			CloneWrapper(H::getvalue(src),H::getvalue(dst),c);
+		}
+	};
+
+	// a value to be put into a container
+	template<typename T>
+	struct CloneMake {
+		inline static T exec(const T &src, cloner &c) {
+			T ret;
+			CloneWrapper(src,ret,c);
+			return ret;
+		}
+	};
+
+	template<typename A, typename B>
+	struct CloneMake<std::pair<A,B> > {
+		typedef typename StripConst<A>::type A0;
+		typedef typename StripConst<B>::type B0;
+		inline static std::pair<A,B> exec(const std::pair<A,B> &src,
+				cloner &c) {
+			return std::pair<A,B>(CloneMake<A0>::exec(src.first,c),
+					CloneMake<B0>::exec(src.second,c));
+		}
+	};
+
+	// Cloning, no pointers or classes within
+	template<typename T>
+	inline typename Type_If<!NeedsClone<T>::value,void>::type
+	CloneWrapper(const T &src, T &dst, cloner &c) {
+		dst = src;
+	}
+
+	// Cloning, class
+	template<typename T>
+	inline typename Type_If<TypeProp<T>::HasIDname
+			&& !PtrInfo<T>::isptr,void>::type
+	CloneWrapper(const T &src, T &dst, cloner &c) {
+		RunPreSave(src);
+		RunPreLoad(dst);
+		CloneItt<typename T::xmlserial_alllist>::exec(&src,&dst,c);
+		RunPostLoad(dst);
+		RunPostSave(src);
+	}
+
+	// Cloning, pointer, non-virtual
+	template<typename T>
+	inline typename Type_If<PtrInfo<T>::isptr
+			&& !TypeProp<typename PtrInfo<T>::BaseType>::HasV,void>::type
+	CloneWrapper(const T &src, T &dst, cloner &c) {
+		if (PtrInfo<T>::isnull(src)) PtrInfo<T>::setnull(dst);
+		else if (!c.lookupptr(src,dst)) {
+			PtrInfo<T>::allocnew(dst);
+			c.addptr(src,dst);
+			CloneWrapper(PtrInfo<T>::deref_const(src),
+					PtrInfo<T>::deref(dst),c);
+		}
+	}
+
+	// copies what src points to (of a subclass of its type) to a new
+	// object, through its text
+	template<typename T>
+	inline void CloneText(const T &src, T &dst) {
+		std::ostringstream os;
+		{
+			archive a(os);
+			Save(src,a);
+		}
+		std::istringstream is(os.str());
+		archive a(is);
+		Load(dst,a);
+	}
+
+	// Cloning, pointer, virtual
+	template<typename T>
+	inline typename Type_If<PtrInfo<T>::isptr
+			&& TypeProp<typename PtrInfo<T>::BaseType>::HasV,void>::type
+	CloneWrapper(const T &src, T &dst, cloner &c) {
+		typedef typename PtrInfo<T>::BaseType BT;
+		if (PtrInfo<T>::isnull(src)) PtrInfo<T>::setnull(dst);
+		else if (!c.lookupptr(src,dst)) {
+			const BT &s = PtrInfo<T>::deref_const(src);
+#ifndef XMLSERIAL_STRUCTURAL
+			if (typeid(s)!=typeid(BT)) {
+				CloneText(src,dst);
+				c.addptr(src,dst);
+				return;
+			}
+#endif
+			BT::xmlserial_valloc::allocbyname(s.xmlserial_namev(),dst);
+			if (PtrInfo<T>::isnull(dst)
+					|| typeid(PtrInfo<T>::deref(dst))!=typeid(s))
+				throw streamexception(std::string("Clone Error: cannot allocate subtype ")+s.xmlserial_namev()+" of "+TypeInfo<BT>::namestr()+" (class not registered?)");
+			c.addptr(src,dst);
+#ifdef XMLSERIAL_STRUCTURAL
+			PtrInfo<T>::deref(dst).xmlserial_clonev(
+					dynamic_cast<const void *>(&s),c);
+#else
+			CloneWrapper(s,PtrInfo<T>::deref(dst),c);
+#endif
+		}
+	}
+
+	// adds elements to the end of a container, in order
+	template<typename T>
+	struct CloneAppender {
+		CloneAppender(T &dst) : c(dst) {}
+		void add(const typename T::value_type &e) { c.insert(c.end(),e); }
+		T &c;
+	};
+
+#if __cplusplus > 199711L
+	// (which has no insert, only insert_after)
+	template<typename E, typename A>
+	struct CloneAppender<std::forward_list<E,A> > {
+		CloneAppender(std::forward_list<E,A> &dst)
+			: c(dst), last(dst.before_begin()) {}
+		void add(const E &e) { last = c.insert_after(last,e); }
+		std::forward_list<E,A> &c;
+		typename std::forward_list<E,A>::iterator last;
+	};
+#endif
+
+	// Cloning, container
+	template<typename T>
+	inline typename Type_If<NeedsClone<T>::value && IsRange<T>::value
+			&& !TypeProp<T>::HasIDname,void>::type
+	CloneWrapper(const T &src, T &dst, cloner &c) {
+		typedef typename T::value_type E;
+		dst.clear();
+		CloneAppender<T> out(dst);
+		for(typename T::const_iterator i=src.begin();i!=src.end();++i)
+			out.add(CloneMake<E>::exec(*i,c));
+	}
+
+	// Cloning, pair
+	template<typename A, typename B>
+	inline typename Type_If<NeedsClone<std::pair<A,B> >::value,void>::type
+	CloneWrapper(const std::pair<A,B> &src, std::pair<A,B> &dst,
+			cloner &c) {
+		CloneWrapper(src.first,dst.first,c);
+		CloneWrapper(src.second,dst.second,c);
+	}
+
+	// Cloning, C array
+	template<typename T, std::size_t N>
+	inline void CloneWrapper(const T (&src)[N], T (&dst)[N], cloner &c) {
+		for(std::size_t i=0;i<N;i++) CloneWrapper(src[i],dst[i],c);
+	}
+
+#if __cplusplus > 199711L
+	// Cloning, std::array
+	template<typename T, std::size_t N>
+	inline typename Type_If<NeedsClone<T>::value,void>::type
+	CloneWrapper(const std::array<T,N> &src, std::array<T,N> &dst,
+			cloner &c) {
+		for(std::size_t i=0;i<N;i++) CloneWrapper(src[i],dst[i],c);
+	}
+#endif
+
+	// deep copy of src into dst
+	template<typename T>
+	void Clone(const T &src, T &dst) {
+		cloner c;
+		CloneWrapper(src,dst,c);
+	}
+
+	// deep copy of src
+	template<typename T>
+	T Clone(const T &src) {
+		cloner c;
+		return CloneMake<T>::exec(src,c);
+	}
+
+}
+
+#endif // of file guard
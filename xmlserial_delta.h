@@ -0,0 +1,294 @@
+/* By Christian R. Shelton
+ * (christian.r.shelton@gmail.com)
+ * August 2014
+ *   [original release]
+ *
+ * Released under MIT software licence:
+ * The MIT License (MIT)
+ * Copyright (c) 2014 Christian R. Shelton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef XMLSERIAL_DELTA_H
+#define XMLSERIAL_DELTA_H
+
+#include <vector>
+#include <cstdlib>
+#include "xmlserial.h"
+
+// Delta saves:  SaveDelta(obj,os,tr) writes only the members of obj that
+// have changed since the last SaveDelta with the same deltatracker.  The
+// tracker keeps a digest (see Hash) of each member from that save, so
+// nothing else of the old state is kept.  Members that are themselves
+// classes (and base classes) are followed, so only their changed members
+// are written too.  Containers and pointers count as one member each.
+//
+// The first save with a tracker (or the first after reset()) writes the
+// whole object.  Each save is numbered (attribute seq), and a delta names
+// the save it is relative to (attribute base):
+//
+//    <Config seq="1"> ... all members ... <\Config>
+//    <Config base="1" delta="1" seq="2"> ... changed members ... <\Config>
+//
+// LoadDelta(obj,is,tr) reads either kind.  A delta is applied onto obj,
+// which must hold the state of its base save (tr checks the numbering).
+// After applying a delta, obj's postload method (if any) is run; preload
+// is only run for whole saves.
+
+namespace XMLSERIALNAMESPACE {
+
+	class deltatracker {
+	public:
+		deltatracker() : seq(0) {}
+
+		// the number of the last save written or loaded (0 if none)
+		long sequence() const { return seq; }
+
+		// forget the last save (the next SaveDelta writes everything)
+		void reset() { digests.clear(); }
+
+		std::vector<hashvalue> digests;
+		long seq;
+	};
+
+	// is T followed member by member?
+	template<typename T>
+	struct IsDeltaClass {
+		enum { value = TypeProp<T>::HasIDname && !PtrInfo<T>::isptr };
+	};
+
+	// the number of digests for a T (one, unless it is a class)
+	template<typename L>
+	struct DeltaListSlots {
+		enum { value = 0 };
+	};
+
+	template<typename T, bool C = IsDeltaClass<T>::value>
+	struct DeltaSlots {
+		enum { value = 1 };
+	};
+
+	template<typename T>
+	struct DeltaSlots<T,true> {
+		enum { value = DeltaListSlots<typename T::xmlserial_alllist>::value };
+	};
+
+	template<typename H, typename T>
+	struct DeltaListSlots<List<H,T> > {
+		enum { value = DeltaListSlots<T>::value
+			+ (IsEmpty<typename H::valtype>::value ? 0
+				: DeltaSlots<typename H::valtype>::value) };
+	};
+
+	// digests of a member (and its members)
+	template<typename T, bool C = IsDeltaClass<T>::value>
+	struct DeltaMember {
+		inline static void digest(const T &t, hashvalue *d, bool) {
+			*d = Hash(t);
+		}
+		// writes member H of o (whose digest has changed)
+		template<typename H, typename ML, typename O, typename S>
+		inline static void savemember(O o, S &os, int indent,
+				const hashvalue *, const hashvalue *) {
+			SaveItem<H>::exec(o,os,indent,MemberId<H,ML>::id());
+		}
+		template<typename S>
+		inline static bool load(T &t, const XMLTagInfo &info, S &is) {
+			LoadWrapper(t,info,is);
+			return true;
+		}
+	};
+
+	template<typename L>
+	struct DeltaItt {
+		template<typename O>
+		inline static void digest(O, hashvalue *, bool) { }
+		template<typename O, typename S>
+		inline static void save(O, S &, int, const hashvalue *,
+				const hashvalue *) { }
+		template<typename O, typename S>
+		inline static bool load(O, S &, const XMLTagInfo &) {
+			return false;
+		}
+	};
+
+	template<typename T>
+	struct DeltaMember<T,true> {
+		typedef typename T::xmlserial_alllist L;
+		// (running t's presave method first, if presave)
+		inline static void digest(const T &t, hashvalue *d, bool presave) {
+			if (presave) RunPreSave(t);
+			DeltaItt<L>::digest(&t,d,presave);
+		}
+		// writes the members of t whose digests differ
+		template<typename S>
+		inline static void save(const T &t, S &os, int indent,
+				const hashvalue *od, const hashvalue *nd) {
+			DeltaItt<L>::save(&t,os,indent,od,nd);
+			RunPostSave(t);
+		}
+		// writes member H of o (some of whose digests have changed):
+		// only its changes
+		template<typename H, typename ML, typename O, typename S>
+		inline static void savemember(O o, S &os, int indent,
+				const hashvalue *od, const hashvalue *nd) {
+			XMLTagInfo fields;
+			fields.name = TypeInfo<T>::namestr();
+			fields.isstart = true;
+			fields.isend = false;
+			if (HasEnc(os,ENC_MEMBERIDS))
+				fields.attr["mid"] = T2str(MemberId<H,ML>::id());
+			else fields.attr["name"] = H::getname(o);
+			fields.attr["delta"] = "1";
+			fields.write(os,indent);
+			os << '\n';
+			save(H::getvalue(o),os,indent+1,od,nd);
+			Indent(os,indent);
+			fields.isstart = false;
+			fields.isend = true;
+			fields.write(os,indent);
+		}
+		// applies a delta (or loads the whole value, if not a delta)
+		template<typename S>
+		inline static bool load(T &t, const XMLTagInfo &info, S &is) {
+			std::map<std::string,std::string>::const_iterator di
+				= info.attr.find("delta");
+			if (di==info.attr.end() || di->second!="1") {
+				LoadWrapper(t,info,is);
+				return true;
+			}
+			const char *cname = TypeInfo<T>::namestr();
+			XMLTagInfo minfo;
+			while(1) {
+				ReadTag(is,minfo);
+				if (minfo.isend && !minfo.isstart) {
+					if (minfo.name != cname)
+						throw streamexception(std::string("Stream Input Format Error: expected end tag for ")+cname+", received end tag for "+minfo.name);
+					break;
+				}
+				if (!DeltaItt<L>::load(&t,is,minfo))
+					throw streamexception(std::string("Extra field ")+minfo.attr["name"]+" of type "+minfo.name+" in object "+cname);
+			}
+			RunPostLoad(t);
+			return true;
+		}
+	};
+
+	template<typename H, typename T>
+	struct DeltaItt<List<H,T> > {
+		typedef typename H::valtype V;
+		enum { skip = IsEmpty<V>::value,
+			pos = DeltaListSlots<T>::value,
+			n = skip ? 0 : DeltaSlots<V>::value };
+
+		template<typename O>
+		inline static void digest(O o, hashvalue *d, bool presave) {
+			DeltaItt<T>::digest(o,d,presave);
+			if (!skip)
+				DeltaMember<V>::digest(H::getvalue(o),d+pos,presave);
+		}
+
+		template<typename O, typename S>
+		inline static void save(O o, S &os, int indent,
+				const hashvalue *od, const hashvalue *nd) {
+			DeltaItt<T>::save(o,os,indent,od,nd);
+			if (skip) return;
+			for(int i=pos;i<pos+n;i++)
+				if (od[i]!=nd[i]) {
+					DeltaMember<V>::template savemember<H,T>(o,os,
+						indent,od+pos,nd+pos);
+					return;
+				}
+		}
+
+		template<typename O, typename S>
+		inline static bool load(O o, S &is, const XMLTagInfo &info) {
+			if (!skip) {
+				std::map<std::string,std::string>::const_iterator ai
+					= info.attr.find("mid");
+				if (ai!=info.attr.end()) {
+					if (strtol(ai->second.c_str(),0,10)==MemberId<H,T>::id())
+						return DeltaMember<V>::load(H::getvalue(o),info,is);
+				} else {
+					ai = info.attr.find("name");
+					if (ai!=info.attr.end() && ai->second==H::getname(o))
+						return DeltaMember<V>::load(H::getvalue(o),info,is);
+				}
+			}
+			return DeltaItt<T>::load(o,is,info);
+		}
+	};
+
+	// saves t, all of it or just its changes since the last save with tr
+	template<typename T, typename S>
+	void SaveDelta(const T &t, S &os, deltatracker &tr, int indent=0) {
+		std::vector<hashvalue> nd(DeltaSlots<T>::value+1);
+		XMLTagInfo fields;
+		fields.attr["seq"] = T2str(tr.seq+1);
+		if (tr.digests.size()!=nd.size()) {
+			// SaveWrapper runs the presave methods, so they are not
+			// run again for the digests
+			SaveWrapper(t,fields,os,indent);
+			DeltaMember<T>::digest(t,&nd[0],false);
+		} else {
+			DeltaMember<T>::digest(t,&nd[0],true);
+			fields.name = TypeInfo<T>::namestr();
+			fields.isstart = true;
+			fields.isend = false;
+			fields.attr["base"] = T2str(tr.seq);
+			fields.attr["delta"] = "1";
+			fields.write(os,indent);
+			os << '\n';
+			DeltaMember<T>::save(t,os,indent+1,&tr.digests[0],&nd[0]);
+			Indent(os,indent);
+			fields.isstart = false;
+			fields.isend = true;
+			fields.write(os,indent);
+		}
+		tr.digests.swap(nd);
+		tr.seq++;
+	}
+
+	// loads t from a whole save, or applies a delta to it
+	template<typename T, typename S>
+	void LoadDelta(T &t, S &is, deltatracker &tr) {
+		XMLTagInfo info;
+		ReadTag(is,info);
+		if (info.name != TypeInfo<T>::namestr())
+			throw streamexception(std::string("Stream Input Format Error: expected start tag for ")+TypeInfo<T>::namestr()+", received tag for "+info.name);
+		std::map<std::string,std::string>::const_iterator ai
+			= info.attr.find("delta");
+		if (ai!=info.attr.end() && ai->second=="1") {
+			ai = info.attr.find("base");
+			long base = ai==info.attr.end() ? -1
+				: strtol(ai->second.c_str(),0,10);
+			if (base!=tr.seq)
+				throw streamexception(std::string("Stream Input Format Error: delta of ")+TypeInfo<T>::namestr()+" is relative to save "+T2str(base)+", but the last save loaded is "+T2str(tr.seq));
+		}
+		DeltaMember<T>::load(t,info,is);
+		ai = info.attr.find("seq");
+		tr.seq = ai==info.attr.end() ? tr.seq+1
+			: strtol(ai->second.c_str(),0,10);
+		tr.digests.clear();
+	}
+
+}
+
+#endif // of file guard
@@ -32,6 +32,7 @@
 #include <deque>
 #include <sstream>
 #include "xmlserial.h"
+#include "xmlserial_bulk.h"
 
 namespace XMLSERIALNAMESPACE {
 	// if T is not "shiftable"
@@ -48,10 +49,11 @@ namespace XMLSERIALNAMESPACE {
 		template<typename S>
 		inline static void save(const std::deque<T,A> &v,
 				S &os,int indent) {
-			os << std::endl;
+			os << '\n';
 			int c=0;
 			for(typename std::deque<T,A>::const_iterator i=v.begin();
 					i!=v.end();++i,++c) {
+				XMLSERIAL_OBSERVE_SAVE(S,namestr(),"",os);
 				XMLTagInfo fields;
 				SaveWrapper(*i,fields,os,indent+1);
 			}
@@ -77,6 +79,7 @@ namespace XMLSERIALNAMESPACE {
 					}
 					throw streamexception(std::string("Stream Input Format Error: expected end tag for ")+namestr()+", received end tag for "+eleminfo.name);
 				}
+				XMLSERIAL_OBSERVE_LOAD(S,namestr(),"",is);
 				if (i>=n) v.resize(n=i+1);
 				LoadWrapper(v[i++],eleminfo,is);
 			}
@@ -94,14 +97,21 @@ namespace XMLSERIALNAMESPACE {
 		template<typename S>
 		inline static void addotherattr(XMLTagInfo &fields, const std::deque<T,A> &v, S &os) {
 			fields.attr["nelem"] = T2str(v.size());
+			if (BulkIO<T>::active(os)) fields.attr["enc"] = "b64";
 		}
 		inline static bool isshort(const std::deque<T,A> &) { return false; }
 		inline static bool isinline(const std::deque<T,A> &) { return false; }
 		template<typename S>
 		inline static void save(const std::deque<T,A> &v,
 				S &os, int indent) {
-			for(typename std::deque<T,A>::const_iterator i=v.begin();i!=v.end();++i)
-				os << *i << ' ';
+			if (BulkIO<T>::active(os)) {
+				BulkIO<T>::save(v.begin(),v.size(),os);
+				return;
+			}
+			for(typename std::deque<T,A>::const_iterator i=v.begin();i!=v.end();++i) {
+				WriteNum(os,*i);
+				os << ' ';
+			}
 		}
 		template<typename S>
 		inline static void load(std::deque<T,A> &v, const XMLTagInfo &info,
@@ -112,8 +122,8 @@ namespace XMLSERIALNAMESPACE {
 				throw streamexception("Stream Input Format Error: deque needs nelem attribute");
 			int n = atoi(ni->second.c_str());
 			v.resize(n);
-			for(int i=0;i<n;i++)
-				is >> v[i];
+			if (IsB64(info)) BulkIO<T>::load(v.begin(),n,is);
+			else TextIO<T>::load(v.begin(),n,is);
 			ReadEndTag(is,namestr());
 		}
 	};
@@ -30,8 +30,10 @@
 #define XMLSERIAL_FORWARD_LIST_H
 
 #include <forward_list>
+#include <iterator>
 #include <sstream>
 #include "xmlserial.h"
+#include "xmlserial_bulk.h"
 
 namespace XMLSERIALNAMESPACE {
 	// if T is not "shiftable"
@@ -47,10 +49,11 @@ namespace XMLSERIALNAMESPACE {
 		template<typename S>
 		inline static void save(const std::forward_list<T,A> &l,
 				S &os,int indent) {
-			os << std::endl;
+			os << '\n';
 			int c=0;
 			for(typename std::forward_list<T,A>::const_iterator i=l.begin();
 					i!=l.end();++i,++c) {
+				XMLSERIAL_OBSERVE_SAVE(S,namestr(),"",os);
 				XMLTagInfo fields;
 				SaveWrapper(*i,fields,os,indent+1);
 			}
@@ -70,6 +73,7 @@ namespace XMLSERIALNAMESPACE {
 					}
 					throw streamexception(std::string("Stream Input Format Error: expected end tag for ")+namestr()+", received end tag for "+eleminfo.name);
 				}
+				XMLSERIAL_OBSERVE_LOAD(S,namestr(),"",is);
 #if _cplusplus <= 199711L
 				prev = l.insert_after(prev,T());
 #else
@@ -90,15 +94,17 @@ namespace XMLSERIALNAMESPACE {
 		}
 		template<typename S>
 		inline static void addotherattr(XMLTagInfo &fields, const std::forward_list<T,A> &l, S &os) {
-			fields.attr["nelem"] = T2str(l.size());
+			fields.attr["nelem"] = T2str(std::distance(l.begin(),l.end()));
 		}
 		inline static bool isshort(const std::forward_list<T,A> &) { return false; }
 		inline static bool isinline(const std::forward_list<T,A> &) { return false; }
 		template<typename S>
 		inline static void save(const std::forward_list<T,A> &l,
 				S &os, int indent) {
-			for(typename std::forward_list<T,A>::const_iterator i=l.begin();i!=l.end();++i)
-				os << *i << ' ';
+			for(typename std::forward_list<T,A>::const_iterator i=l.begin();i!=l.end();++i) {
+				WriteNum(os,*i);
+				os << ' ';
+			}
 		}
 		template<typename S>
 		inline static void load(std::forward_list<T,A> &l, const XMLTagInfo &info,
@@ -108,15 +114,8 @@ namespace XMLSERIALNAMESPACE {
 			if (ni == info.attr.end())
 				throw streamexception("Stream Input Format Error: forward_list (when elements are saved with <<) needs nelem attribute");
 			int n = atoi(ni->second.c_str());
-			typename std::forward_list<T,A>::iterator prev = l.before_begin();
-			for(int i=0;i<n;i++) {
-#if _cplusplus <= 199711L
-				prev = l.insert_after(prev,T());
-#else
-                    prev = l.emplace_after(prev);
-#endif
-				is >> *prev;
-			}
+			l.resize(n);
+			TextIO<T>::load(l.begin(),n,is);
 			ReadEndTag(is,namestr());
 		}
 	};
@@ -0,0 +1,537 @@
+/* By Christian R. Shelton
+ * (christian.r.shelton@gmail.com)
+ * August 2014
+ *   [original release]
+ *
+ * Released under MIT software licence:
+ * The MIT License (MIT)
+ * Copyright (c) 2014 Christian R. Shelton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef XMLSERIAL_HASH_H
+#define XMLSERIAL_HASH_H
+
+#include <map>
+#include <iterator>
+#include <string>
+#include <sstream>
+#include <typeinfo>
+#include <limits>
+#include <string.h>
+
+// Hashing and comparing:  Hash(obj) is a 64-bit digest of obj's content,
+// and Equal(a,b) a deep comparison, both walking the same members (and
+// pointers) as Save, but without writing any text.
+//
+// Numbers are hashed by value (so an int and a long holding 3 hash the
+// same, whatever their sizes on the platform), strings by their
+// bytes, containers in order (and unordered containers independently of
+// their order), and pointers by what they point to.  An object pointed to
+// a second time is hashed as a reference to the first time, so both the
+// values and the shape of shared or cyclic structures count (Equal
+// likewise requires pointers to correspond one-to-one).  Within
+// unordered containers, each element is taken on its own (and elements
+// with pointer keys are matched up by what the keys point to, not by
+// their addresses).
+//
+// Objects of a subclass of a pointer's type are walked through virtual
+// methods if compiled with XMLSERIAL_STRUCTURAL (see xmlserial.h), and
+// otherwise hashed or compared as their text, on their own (so sharing
+// between them and the rest counts only through the pointers to them).
+//
+// If Equal(a,b) then Hash(a)==Hash(b).  Types with no other way to be
+// hashed (ones using XMLSERIAL_USESHIFT, for instance) are saved to a
+// string, which is then hashed or compared.
+
+namespace XMLSERIALNAMESPACE {
+
+	typedef unsigned long long hashvalue;
+
+	// can T be hashed by its value as a number?
+	template<typename T>
+	struct IsHashNum {
+		enum { value = false };
+	};
+
+#define XMLSERIAL_HASHNUM(tname) \
+	template<> \
+	struct IsHashNum<tname> { \
+		enum { value = true }; \
+	};
+
+	XMLSERIAL_HASHNUM(bool)
+	XMLSERIAL_HASHNUM(char)
+	XMLSERIAL_HASHNUM(signed char)
+	XMLSERIAL_HASHNUM(unsigned char)
+	XMLSERIAL_HASHNUM(short)
+	XMLSERIAL_HASHNUM(unsigned short)
+	XMLSERIAL_HASHNUM(int)
+	XMLSERIAL_HASHNUM(unsigned int)
+	XMLSERIAL_HASHNUM(long)
+	XMLSERIAL_HASHNUM(unsigned long)
+	XMLSERIAL_HASHNUM(float)
+	XMLSERIAL_HASHNUM(double)
+	XMLSERIAL_HASHNUM(long double)
+#if __cplusplus > 199711L
+	XMLSERIAL_HASHNUM(long long)
+	XMLSERIAL_HASHNUM(unsigned long long)
+#endif
+
+#undef XMLSERIAL_HASHNUM
+
+	// is T an unordered (hashed) container?
+	template<typename T>
+	struct IsUnordered {
+		template<typename S> static char
+			(& chk(typename S::hasher *))[1];
+		template<typename> static char (& chk(...))[2];
+		enum { value = sizeof(chk<T>(0)) == 1 };
+	};
+
+	// does T map keys to values?
+	template<typename T>
+	struct IsMapping {
+		template<typename S> static char
+			(& chk(typename S::mapped_type *))[1];
+		template<typename> static char (& chk(...))[2];
+		enum { value = sizeof(chk<T>(0)) == 1 };
+	};
+
+	enum { HASH_OTHER, HASH_PTR, HASH_CLASS, HASH_NUM, HASH_SEQ,
+		HASH_UNORDERED, HASH_STRING, HASH_PAIR, HASH_CARRAY };
+
+	// how T is hashed and compared
+	template<typename T>
+	struct HashKind {
+		enum { value = PtrInfo<T>::isptr ? HASH_PTR
+			: TypeProp<T>::HasIDname ? HASH_CLASS
+			: IsHashNum<T>::value ? HASH_NUM
+			: !IsRange<T>::value ? HASH_OTHER
+			: IsUnordered<T>::value ? HASH_UNORDERED : HASH_SEQ };
+	};
+	template<typename C, typename T, typename A>
+	struct HashKind<std::basic_string<C,T,A> > {
+		enum { value = HASH_STRING };
+	};
+	template<typename A, typename B>
+	struct HashKind<std::pair<A,B> > {
+		enum { value = HASH_PAIR };
+	};
+	template<typename T, std::size_t N>
+	struct HashKind<T[N]> {
+		enum { value = HASH_CARRAY };
+	};
+
+	// accumulates a digest
+	class hasher {
+	public:
+		hasher() : h(0x6a09e667f3bcc908ULL), n(0) {}
+
+		void add(hashvalue v) {
+			h = Mix((h ^ v)*0x9e3779b97f4a7c15ULL + (++n));
+		}
+
+		void add(const char *s, std::size_t len) {
+			const unsigned char *u = (const unsigned char *)s;
+			add(hashvalue(len));
+			for(;len>=8;len-=8,u+=8)
+				add(hashvalue(u[0]) | hashvalue(u[1])<<8
+					| hashvalue(u[2])<<16 | hashvalue(u[3])<<24
+					| hashvalue(u[4])<<32 | hashvalue(u[5])<<40
+					| hashvalue(u[6])<<48 | hashvalue(u[7])<<56);
+			hashvalue last = 0;
+			for(std::size_t i=0;i<len;i++) last |= hashvalue(u[i])<<(8*i);
+			add(last);
+		}
+
+		void add(double d) {
+			if (d==0) d = 0; // -0 is equal to 0
+			hashvalue v = 0;
+			memcpy(&v,&d,sizeof(d));
+			add(v);
+		}
+
+		// returns true (and the number of the first time) if the object
+		// p has been hashed already
+		bool seen(const void *p, hashvalue &first) {
+			std::pair<visitT::iterator,bool> loc
+				= visited.insert(std::make_pair(p,hashvalue(visited.size())));
+			first = loc.first->second;
+			return !loc.second;
+		}
+
+		hashvalue digest() const { return Mix(h ^ n); }
+
+		static hashvalue Mix(hashvalue x) {
+			x ^= x>>30; x *= 0xbf58476d1ce4e5b9ULL;
+			x ^= x>>27; x *= 0x94d049bb133111ebULL;
+			x ^= x>>31;
+			return x;
+		}
+
+	private:
+		hashvalue h, n;
+		typedef std::map<const void *,hashvalue> visitT;
+		visitT visited;
+	};
+
+	// keeps the pairing of pointed-to objects during a comparison
+	class comparer {
+	public:
+		// false if a or b has already been paired with something else;
+		// seen is set if they were paired with each other
+		bool pair(const void *a, const void *b, bool &seen) {
+			std::map<const void *,const void *>::iterator ia = a2b.find(a);
+			std::map<const void *,const void *>::iterator ib = b2a.find(b);
+			seen = ia!=a2b.end();
+			if (seen || ib!=b2a.end())
+				return seen && ib!=b2a.end() && ia->second==b;
+			a2b[a] = b;
+			b2a[b] = a;
+			return true;
+		}
+	private:
+		std::map<const void *,const void *> a2b, b2a;
+	};
+
+	template<typename T>
+	inline std::string HashText(const T &t) {
+		std::ostringstream ss;
+		Save(t,ss);
+		return ss.str();
+	}
+
+	// the text of t, an object of a subclass of T, as pointed to (through
+	// an archive, so pointers within it are followed as in a Save)
+	template<typename T>
+	inline std::string PointeeText(const T &t) {
+		std::ostringstream ss;
+		archive a(ss);
+		T *p = const_cast<T *>(&t);
+		Save(p,a);
+		return ss.str();
+	}
+
+	// the members of a class, one by one
+	template<typename L>
+	struct HashItt {
+	};
+
+	template<>
+	struct HashItt<ListEnd> {
+		template<typename O>
+		inline static void exec(const O *o, hasher &h) { }
+		template<typename O>
+		inline static bool equal(const O *a, const O *b, comparer &c) {
+			return true;
+		}
+	};
+
+	template<typename H, typename T>
+	struct HashItt<List<H,T> > {
+		template<typename O>
+		inline static void exec(const O *o, hasher &h) {
+			HashItt<T>::exec(o,h);
+			HashWrapper(H::getvalue(o),h);
+		}
+		template<typename O>
+		inline static bool equal(const O *a, const O *b, comparer &c) {
+			return HashItt<T>::equal(a,b,c)
+				&& EqualWrapper(H::getvalue(a),H::getvalue(b),c);
+		}
+	};
+
+	// Hashing, number
+	template<typename T>
+	inline typename Type_If<HashKind<T>::value==HASH_NUM,void>::type
+	HashWrapper(const T &t, hasher &h) {
+		if (std::numeric_limits<T>::is_integer)
+			h.add(hashvalue((long long)t));
+		else h.add((double)t);
+	}
+
+	// Hashing, string
+	template<typename T>
+	inline typename Type_If<HashKind<T>::value==HASH_STRING,void>::type
+	HashWrapper(const T &t, hasher &h) {
+		h.add((const char *)t.data(),t.length()*sizeof(t[0]));
+	}
+
+	// Hashing, class
+	template<typename T>
+	inline typename Type_If<HashKind<T>::value==HASH_CLASS,void>::type
+	HashWrapper(const T &t, hasher &h) {
+		HashItt<typename T::xmlserial_alllist>::exec(&t,h);
+	}
+
+	// Hashing, pointer
+	template<typename T>
+	inline typename Type_If<HashKind<T>::value==HASH_PTR,void>::type
+	HashWrapper(const T &t, hasher &h) {
+		hashvalue first;
+		if (PtrInfo<T>::isnull(t)) h.add(hashvalue(0));
+		else if (h.seen(PtrInfo<T>::getptr(t),first)) {
+			h.add(hashvalue(1));
+			h.add(first);
+		} else {
+			h.add(hashvalue(2));
+			HashPointee(PtrInfo<T>::deref_const(t),h);
+		}
+	}
+
+	template<typename T>
+	inline typename Type_If<!TypeProp<T>::HasV,void>::type
+	HashPointee(const T &t, hasher &h) {
+		HashWrapper(t,h);
+	}
+
+	template<typename T>
+	inline typename Type_If<TypeProp<T>::HasV,void>::type
+	HashPointee(const T &t, hasher &h) {
+		const char *name = t.xmlserial_namev();
+		h.add(name,strlen(name));
+#ifdef XMLSERIAL_STRUCTURAL
+		t.xmlserial_hashv(h);
+#else
+		if (typeid(t)==typeid(T)) HashWrapper(t,h);
+		else {
+			std::string text = PointeeText(t);
+			h.add(text.data(),text.length());
+		}
+#endif
+	}
+
+	// Hashing, container (in order)
+	template<typename T>
+	inline typename Type_If<HashKind<T>::value==HASH_SEQ,void>::type
+	HashWrapper(const T &t, hasher &h) {
+		// (counted, as forward_list has no size)
+		h.add(hashvalue(std::distance(t.begin(),t.end())));
+		for(typename T::const_iterator i=t.begin();i!=t.end();++i)
+			HashWrapper(*i,h);
+	}
+
+	// Hashing, unordered container (each element on its own, summed)
+	template<typename T>
+	inline typename Type_If<HashKind<T>::value==HASH_UNORDERED,void>::type
+	HashWrapper(const T &t, hasher &h) {
+		hashvalue sum = 0;
+		for(typename T::const_iterator i=t.begin();i!=t.end();++i) {
+			hasher eh;
+			HashWrapper(*i,eh);
+			sum += eh.digest();
+		}
+		h.add(hashvalue(t.size()));
+		h.add(sum);
+	}
+
+	// Hashing, pair
+	template<typename A, typename B>
+	inline void HashWrapper(const std::pair<A,B> &t, hasher &h) {
+		HashWrapper(t.first,h);
+		HashWrapper(t.second,h);
+	}
+
+	// Hashing, C array
+	template<typename T, std::size_t N>
+	inline void HashWrapper(const T (&t)[N], hasher &h) {
+		for(std::size_t i=0;i<N;i++) HashWrapper(t[i],h);
+	}
+
+	// Hashing, anything else (as its text)
+	template<typename T>
+	inline typename Type_If<HashKind<T>::value==HASH_OTHER,void>::type
+	HashWrapper(const T &t, hasher &h) {
+		std::string s = HashText(t);
+		h.add(s.data(),s.length());
+	}
+
+	// Comparing, number or string
+	template<typename T>
+	inline typename Type_If<HashKind<T>::value==HASH_NUM
+			|| HashKind<T>::value==HASH_STRING,bool>::type
+	EqualWrapper(const T &a, const T &b, comparer &c) {
+		return a==b;
+	}
+
+	// Comparing, class
+	template<typename T>
+	inline typename Type_If<HashKind<T>::value==HASH_CLASS,bool>::type
+	EqualWrapper(const T &a, const T &b, comparer &c) {
+		return HashItt<typename T::xmlserial_alllist>::equal(&a,&b,c);
+	}
+
+	// Comparing, pointer
+	template<typename T>
+	inline typename Type_If<HashKind<T>::value==HASH_PTR,bool>::type
+	EqualWrapper(const T &a, const T &b, comparer &c) {
+		if (PtrInfo<T>::isnull(a) || PtrInfo<T>::isnull(b))
+			return PtrInfo<T>::isnull(a) && PtrInfo<T>::isnull(b);
+		bool seen;
+		if (!c.pair(PtrInfo<T>::getptr(a),PtrInfo<T>::getptr(b),seen))
+			return false;
+		return seen || EqualPointee(PtrInfo<T>::deref_const(a),
+					PtrInfo<T>::deref_const(b),c);
+	}
+
+	template<typename T>
+	inline typename Type_If<!TypeProp<T>::HasV,bool>::type
+	EqualPointee(const T &a, const T &b, comparer &c) {
+		return EqualWrapper(a,b,c);
+	}
+
+	template<typename T>
+	inline typename Type_If<TypeProp<T>::HasV,bool>::type
+	EqualPointee(const T &a, const T &b, comparer &c) {
+		if (typeid(a)!=typeid(b)) return false;
+#ifdef XMLSERIAL_STRUCTURAL
+		return a.xmlserial_equalv(dynamic_cast<const void *>(&b),c);
+#else
+		if (typeid(a)==typeid(T)) return EqualWrapper(a,b,c);
+		return PointeeText(a)==PointeeText(b);
+#endif
+	}
+
+	// Comparing, container (in order)
+	template<typename T>
+	inline typename Type_If<HashKind<T>::value==HASH_SEQ,bool>::type
+	EqualWrapper(const T &a, const T &b, comparer &c) {
+		typename T::const_iterator i=a.begin(), j=b.begin();
+		for(;i!=a.end() && j!=b.end();++i,++j)
+			if (!EqualWrapper(*i,*j,c)) return false;
+		return i==a.end() && j==b.end();
+	}
+
+	// the key of an element of a container
+	template<typename T, bool M = IsMapping<T>::value>
+	struct KeyOf {
+		static const typename T::value_type &
+			get(const typename T::value_type &e) { return e; }
+	};
+	template<typename T>
+	struct KeyOf<T,true> {
+		static const typename T::key_type &
+			get(const typename T::value_type &e) { return e.first; }
+	};
+
+	// the elements of an unordered container, as the container finds
+	// them: by key, or, for pointer keys (which it finds by address),
+	// by the hash of what they point to
+	template<typename T, bool P = PtrInfo<typename T::key_type>::isptr>
+	struct ElemGroups {
+		typedef typename T::const_iterator itT;
+		ElemGroups(const T &c) : c(c) {}
+		// number of elements equal to e
+		std::size_t count(const typename T::value_type &e) const {
+			std::pair<itT,itT> r = c.equal_range(KeyOf<T>::get(e));
+			std::size_t n=0;
+			for(itT j=r.first;j!=r.second;++j) {
+				comparer ec;
+				if (EqualWrapper(e,*j,ec)) n++;
+			}
+			return n;
+		}
+	private:
+		const T &c;
+	};
+	template<typename T>
+	struct ElemGroups<T,true> {
+		typedef typename T::const_iterator itT;
+		typedef std::multimap<hashvalue,const typename T::value_type *> groupT;
+		ElemGroups(const T &c) {
+			for(itT i=c.begin();i!=c.end();++i)
+				groups.insert(std::make_pair(digest(*i),&*i));
+		}
+		std::size_t count(const typename T::value_type &e) const {
+			std::pair<typename groupT::const_iterator,
+				typename groupT::const_iterator> r
+				= groups.equal_range(digest(e));
+			std::size_t n=0;
+			for(;r.first!=r.second;++r.first) {
+				comparer ec;
+				if (EqualWrapper(e,*r.first->second,ec)) n++;
+			}
+			return n;
+		}
+	private:
+		static hashvalue digest(const typename T::value_type &e) {
+			hasher eh;
+			HashWrapper(e,eh);
+			return eh.digest();
+		}
+		groupT groups;
+	};
+
+	// Comparing, unordered container (each element on its own)
+	template<typename T>
+	inline typename Type_If<HashKind<T>::value==HASH_UNORDERED,bool>::type
+	EqualWrapper(const T &a, const T &b, comparer &c) {
+		typedef typename T::const_iterator itT;
+		if (a.size()!=b.size()) return false;
+		ElemGroups<T> ga(a), gb(b);
+		// as many equal to *i in each
+		for(itT i=a.begin();i!=a.end();++i)
+			if (ga.count(*i)!=gb.count(*i)) return false;
+		return true;
+	}
+
+	// Comparing, pair
+	template<typename A, typename B>
+	inline bool EqualWrapper(const std::pair<A,B> &a,
+			const std::pair<A,B> &b, comparer &c) {
+		return EqualWrapper(a.first,b.first,c)
+			&& EqualWrapper(a.second,b.second,c);
+	}
+
+	// Comparing, C array
+	template<typename T, std::size_t N>
+	inline bool EqualWrapper(const T (&a)[N], const T (&b)[N],
+			comparer &c) {
+		for(std::size_t i=0;i<N;i++)
+			if (!EqualWrapper(a[i],b[i],c)) return false;
+		return true;
+	}
+
+	// Comparing, anything else (as its text)
+	template<typename T>
+	inline typename Type_If<HashKind<T>::value==HASH_OTHER,bool>::type
+	EqualWrapper(const T &a, const T &b, comparer &c) {
+		return HashText(a)==HashText(b);
+	}
+
+	// digest of t's content
+	template<typename T>
+	hashvalue Hash(const T &t) {
+		hasher h;
+		HashWrapper(t,h);
+		return h.digest();
+	}
+
+	// whether a and b have the same content
+	template<typename T>
+	bool Equal(const T &a, const T &b) {
+		comparer c;
+		return EqualWrapper(a,b,c);
+	}
+
+}
+
+#endif // of file guard
@@ -0,0 +1,169 @@
+/* By Christian R. Shelton
+ * (christian.r.shelton@gmail.com)
+ * August 2014
+ *   [original release]
+ *
+ * Released under MIT software licence:
+ * The MIT License (MIT)
+ * Copyright (c) 2014 Christian R. Shelton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef XMLSERIAL_INTERNED_H
+#define XMLSERIAL_INTERNED_H
+
+#include <string>
+#if __cplusplus > 199711L
+#include <unordered_set>
+#include <mutex>
+#else
+#include <set>
+#endif
+#include "xmlserial.h"
+#include "xmlserial_string.h"
+
+// Interned strings:  an interned_string is a handle to a string kept
+// in a stringpool, so loading many equal values keeps only one copy.
+//
+// The pool used when loading is the one attached to the stream (or
+// archive) with usepool; if there is none, stringpool::global() is used.
+// Handles are valid as long as their pool.  In C++11, strings can be
+// interned from several threads at once (shards loaded in parallel with
+// LoadShards share the global pool, say); clearing a pool is not
+// thread-safe, and otherwise pools are not thread-safe at all.
+//
+// interned_strings are saved just as std::strings are.
+
+namespace XMLSERIALNAMESPACE {
+
+	class stringpool {
+	public:
+		// the pooled string equal to s (added if not already there)
+		const std::string *intern(const std::string &s) {
+#if __cplusplus > 199711L
+			std::lock_guard<std::mutex> lock(m);
+#endif
+			return &*strs.insert(s).first;
+		}
+		std::size_t size() const {
+#if __cplusplus > 199711L
+			std::lock_guard<std::mutex> lock(m);
+#endif
+			return strs.size();
+		}
+		void clear() { strs.clear(); }
+
+		static stringpool &global() {
+			static stringpool p;
+			return p;
+		}
+
+	private:
+		// (neither moves its elements as it grows)
+#if __cplusplus > 199711L
+		std::unordered_set<std::string> strs;
+		mutable std::mutex m;
+#else
+		std::set<std::string> strs;
+#endif
+	};
+
+	inline int PoolIndex() {
+		static int i = std::ios_base::xalloc();
+		return i;
+	}
+
+	// strings loaded from s are interned in p (which must outlive
+	// the loading)
+	template<typename S>
+	inline void usepool(S &s, stringpool &p) {
+		s.pword(PoolIndex()) = &p;
+	}
+
+	template<typename S>
+	inline stringpool &PoolOf(S &s) {
+		void *p = s.pword(PoolIndex());
+		return p ? *static_cast<stringpool *>(p) : stringpool::global();
+	}
+
+	class interned_string {
+	public:
+		interned_string() : p(&emptystr()) {}
+		interned_string(const std::string &s, stringpool &pool
+					= stringpool::global()) : p(pool.intern(s)) {}
+
+		const std::string &str() const { return *p; }
+		operator const std::string &() const { return *p; }
+		const char *c_str() const { return p->c_str(); }
+		std::size_t size() const { return p->size(); }
+		std::size_t length() const { return p->length(); }
+		bool empty() const { return p->empty(); }
+
+		// equal strings from the same pool are the same string
+		bool operator==(const interned_string &s) const {
+			return p==s.p || *p==*s.p;
+		}
+		bool operator!=(const interned_string &s) const {
+			return !(*this==s);
+		}
+		bool operator<(const interned_string &s) const {
+			return p!=s.p && *p<*s.p;
+		}
+
+	private:
+		static const std::string &emptystr() {
+			static const std::string e;
+			return e;
+		}
+		const std::string *p;
+	};
+
+	inline std::ostream &operator<<(std::ostream &os, const interned_string &s) {
+		return os << s.str();
+	}
+
+	template<>
+	struct TypeInfo<interned_string,void> {
+		inline static const char *namestr() { return "string"; }
+		template<typename S>
+		inline static void addotherattr(XMLTagInfo &fields,
+				const interned_string &s, S &os) {
+			TypeInfo<std::string>::addotherattr(fields,s.str(),os);
+		}
+		inline static bool isshort(const interned_string &s) {
+			return TypeInfo<std::string>::isshort(s.str());
+		}
+		inline static bool isinline(const interned_string &s) { return false; }
+		template<typename S>
+		inline static void save(const interned_string &s, S &os,
+				int indent) {
+			TypeInfo<std::string>::save(s.str(),os,indent);
+		}
+		template<typename S>
+		inline static void load(interned_string &s, const XMLTagInfo &info,
+				S &is) {
+			std::string str;
+			TypeInfo<std::string>::load(str,info,is);
+			s = interned_string(str,PoolOf(is));
+		}
+	};
+
+}
+#endif
@@ -0,0 +1,227 @@
+/* By Christian R. Shelton
+ * (christian.r.shelton@gmail.com)
+ * August 2014
+ *   [original release]
+ *
+ * Released under MIT software licence:
+ * The MIT License (MIT)
+ * Copyright (c) 2014 Christian R. Shelton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef XMLSERIAL_LAZY_H
+#define XMLSERIAL_LAZY_H
+
+#include <string>
+#include <istream>
+#include "xmlserial.h"
+#include "xmlserial_skip.h"
+#include "xmlserial_borrowed.h"
+
+// lazy<T>: a member whose loading is put off until it is used.
+//
+// Loading a lazy<T> only finds the end of its element (with SkipElement)
+// and keeps the element's text.  The text is parsed into a T the first
+// time get() is called.  Saving a lazy<T> whose value has not been
+// changed writes the kept text back out as it was, without making a T
+// or converting it to text again.
+//
+// Loaded from a stream reading from a membuffer, a lazy<T> keeps only
+// where its text is in the membuffer's memory (and so, until it is
+// parsed or changed, is valid only as long as that memory is); loaded
+// from any other stream, it keeps a copy of the text.
+//
+// The element is parsed on its own, so T must not hold pointers (or
+// strings written through an archive's string table) that refer to
+// other parts of an archive.  For the same reason, a lazy<T> is always
+// saved as if to a plain stream, even when saved to an archive.
+
+namespace XMLSERIALNAMESPACE {
+
+	template<typename T>
+	class lazy {
+	public:
+		lazy() : val(), pending(false), hastext(false), body(0),
+				len(0), bodylen(0) {}
+		lazy(const T &t) : val(t), pending(false), hastext(false),
+				body(0), len(0), bodylen(0) {}
+		lazy(const lazy &l) : val(l.val), pending(false), hastext(false),
+				body(0), len(0), bodylen(0) {
+			copytext(l);
+		}
+
+		lazy &operator=(const lazy &l) {
+			if (this!=&l) {
+				val = l.val;
+				drop();
+				copytext(l);
+			}
+			return *this;
+		}
+		lazy &operator=(const T &t) {
+			val = t;
+			drop();
+			return *this;
+		}
+
+		// the value, parsed now if not yet:  the non-const version lets
+		// the value be changed, so its text is no longer used
+		T &get() {
+			parse();
+			drop();
+			return val;
+		}
+		const T &get() const {
+			parse();
+			return val;
+		}
+
+		T &operator*() { return get(); }
+		const T &operator*() const { return get(); }
+		T *operator->() { return &get(); }
+		const T *operator->() const { return &get(); }
+
+		// true if loaded and not yet parsed
+		bool ispending() const { return pending; }
+		// true if the value will be saved from the text it was loaded from
+		bool isverbatim() const { return hastext; }
+
+		// parses the text now (throwing streamexception if it does not
+		// parse), if not yet
+		void parse() const {
+			if (!pending) return;
+			membuffer mb(body,body+len);
+			std::istream is(&mb);
+			LoadWrapper(val,info,is);
+			pending = false;
+		}
+
+	private:
+		friend struct TypeInfo<lazy<T>,void>;
+
+		// forgets the text (the value must have been parsed)
+		void drop() {
+			pending = hastext = false;
+			text.clear();
+			body = 0;
+			len = bodylen = 0;
+		}
+
+		// the text is [body,body+len):  the element's contents
+		// ([body,body+bodylen)) followed by its end tag
+		void settext(const XMLTagInfo &start, const char *b,
+				std::size_t n, std::size_t nbody) {
+			info = start;
+			body = b;
+			len = n;
+			bodylen = nbody;
+			pending = hastext = true;
+		}
+		// (s's contents are taken)
+		void settext(const XMLTagInfo &start, std::string &s,
+				std::size_t nbody) {
+			text.swap(s);
+			settext(start,text.data(),text.length(),nbody);
+		}
+
+		void copytext(const lazy &l) {
+			if (!l.hastext) return;
+			if (l.body==l.text.data()) {
+				std::string s(l.text);
+				settext(l.info,s,l.bodylen);
+			} else settext(l.info,l.body,l.len,l.bodylen);
+			pending = l.pending;
+		}
+
+		mutable T val;
+		mutable bool pending;
+		bool hastext;
+		XMLTagInfo info; // the start tag
+		std::string text; // (if not borrowed from a membuffer)
+		const char *body;
+		std::size_t len, bodylen;
+	};
+
+	template<typename T>
+	struct TypeInfo<lazy<T>,void> {
+		inline static const char *namestr() { return TypeInfo<T>::namestr(); }
+		template<typename S>
+		inline static void addotherattr(XMLTagInfo &fields,
+				const lazy<T> &v, S &os) {
+			if (!v.hastext) {
+				TypeInfo<T>::addotherattr(fields,v.val,os);
+				return;
+			}
+			for(std::map<std::string,std::string>::const_iterator
+					i=v.info.attr.begin();i!=v.info.attr.end();++i)
+				if (!placeattr(i->first)) fields.attr.insert(*i);
+		}
+		// is a an attribute saying where the element was (its member
+		// name or id, or ids within its archive), rather than one the
+		// kept text needs (value, len, enc, nelem, ...)?
+		inline static bool placeattr(const std::string &a) {
+			static const char *const place[] = { "name", "mid", "ptrid",
+				"ptrcache", "isnull", "sid", "sref", "xshard" };
+			for(std::size_t i=0;i<sizeof(place)/sizeof(place[0]);i++)
+				if (a==place[i]) return true;
+			return false;
+		}
+		inline static bool isshort(const lazy<T> &v) {
+			return !v.hastext && TypeInfo<T>::isshort(v.val);
+		}
+		inline static bool isinline(const lazy<T> &v) {
+			return v.hastext ? v.info.isend : TypeInfo<T>::isinline(v.val);
+		}
+		template<typename S>
+		inline static void save(const lazy<T> &v, S &os, int indent) {
+			if (v.hastext) {
+				os.write(v.body,v.bodylen);
+				return;
+			}
+			std::ostream out(os.rdbuf());
+			dupfmt(out,os);
+			TypeInfo<T>::save(v.val,out,indent);
+		}
+		template<typename S>
+		inline static void load(lazy<T> &v, const XMLTagInfo &info,
+				S &is) {
+			v.drop();
+			if (info.isend) {
+				v.settext(info,"",0,0);
+				return;
+			}
+			membuffer *mb = dynamic_cast<membuffer *>(is.rdbuf());
+			if (mb) {
+				const char *b = mb->pos(), *bodyend;
+				const char *e = SkipElement(b,mb->limit(),info.name,bodyend);
+				mb->skip(e-b);
+				v.settext(info,b,e-b,bodyend-b);
+			} else {
+				std::string s;
+				SkipElement(is,info,&s);
+				std::size_t nbody = s.length();
+				s.append("<\\").append(info.name).append(">");
+				v.settext(info,s,nbody);
+			}
+		}
+	};
+}
+
+#endif // of file guard
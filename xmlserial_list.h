@@ -32,6 +32,7 @@
 #include <list>
 #include <sstream>
 #include "xmlserial.h"
+#include "xmlserial_bulk.h"
 
 namespace XMLSERIALNAMESPACE {
 	// if T is not "shiftable"
@@ -47,10 +48,11 @@ namespace XMLSERIALNAMESPACE {
 		template<typename S>
 		inline static void save(const std::list<T,A> &l,
 				S &os,int indent) {
-			os << std::endl;
+			os << '\n';
 			int c=0;
 			for(typename std::list<T,A>::const_iterator i=l.begin();
 					i!=l.end();++i,++c) {
+				XMLSERIAL_OBSERVE_SAVE(S,namestr(),"",os);
 				XMLTagInfo fields;
 				SaveWrapper(*i,fields,os,indent+1);
 			}
@@ -69,6 +71,7 @@ namespace XMLSERIALNAMESPACE {
 					}
 					throw streamexception(std::string("Stream Input Format Error: expected end tag for ")+namestr()+", received end tag for "+eleminfo.name);
 				}
+				XMLSERIAL_OBSERVE_LOAD(S,namestr(),"",is);
 #if _cplusplus <= 199711L
 				l.push_back(T());
 #else
@@ -96,8 +99,10 @@ namespace XMLSERIALNAMESPACE {
 		template<typename S>
 		inline static void save(const std::list<T,A> &l,
 				S &os, int indent) {
-			for(typename std::list<T,A>::const_iterator i=l.begin();i!=l.end();++i)
-				os << *i << ' ';
+			for(typename std::list<T,A>::const_iterator i=l.begin();i!=l.end();++i) {
+				WriteNum(os,*i);
+				os << ' ';
+			}
 		}
 		template<typename S>
 		inline static void load(std::list<T,A> &l, const XMLTagInfo &info,
@@ -107,15 +112,8 @@ namespace XMLSERIALNAMESPACE {
 			if (ni == info.attr.end())
 				throw streamexception("Stream Input Format Error: list (when elements are saved with <<) needs nelem attribute");
 			int n = atoi(ni->second.c_str());
-
-			for(int i=0;i<n;i++) {
-#if _cplusplus <= 199711L
-				l.push_back(T());
-#else
-                    l.emplace_back();
-#endif
-				is >> l.back();
-			}
+			l.resize(n);
+			TextIO<T>::load(l.begin(),n,is);
 			ReadEndTag(is,namestr());
 		}
 	};
@@ -46,10 +46,11 @@ namespace XMLSERIALNAMESPACE {
 		template<typename S>
 		inline static void save(const std::multiset<T,C,A> &s,
 				S &os,int indent) {
-			os << std::endl;
+			os << '\n';
 			int c=0;
 			for(typename std::multiset<T,C,A>::const_iterator i=s.begin();
 					i!=s.end();++i,++c) {
+				XMLSERIAL_OBSERVE_SAVE(S,namestr(),"",os);
 				XMLTagInfo fields;
 				SaveWrapper(*i,fields,os,indent+1);
 			}
@@ -67,6 +68,7 @@ namespace XMLSERIALNAMESPACE {
 					if (eleminfo.name == namestr()) return;
 					throw streamexception(std::string("Stream Input Format Error: expected end tag for ")+namestr()+", received end tag for "+eleminfo.name);
 				}
+				XMLSERIAL_OBSERVE_LOAD(S,namestr(),"",is);
 				T temp;
 				LoadWrapper(temp,eleminfo,is);
 				s.insert(temp);
@@ -92,8 +94,10 @@ namespace XMLSERIALNAMESPACE {
 		template<typename S>
 		inline static void save(const std::multiset<T,C,A> &s,
 				S &os, int indent) {
-			for(typename std::multiset<T,C,A>::const_iterator i=s.begin();i!=s.end();++i)
-				os << *i << ' ';
+			for(typename std::multiset<T,C,A>::const_iterator i=s.begin();i!=s.end();++i) {
+				WriteNum(os,*i);
+				os << ' ';
+			}
 		}
 		template<typename S>
 		inline static void load(std::multiset<T,C,A> &s, const XMLTagInfo &info,
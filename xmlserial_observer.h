@@ -0,0 +1,128 @@
+/* By Christian R. Shelton
+ * (christian.r.shelton@gmail.com)
+ * August 2014
+ *   [original release]
+ *
+ * Released under MIT software licence:
+ * The MIT License (MIT)
+ * Copyright (c) 2014 Christian R. Shelton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef XMLSERIAL_OBSERVER_H
+#define XMLSERIAL_OBSERVER_H
+
+// Observers:  a class with static methods
+//
+//    static void on_begin(const char *type, const char *member,
+//                         long long offset);
+//    static void on_end(const char *type, const char *member,
+//                       long long offset);
+//
+// is told as saving or loading enters and leaves each class member (type
+// is then the class's name and member the member's) and each element of
+// a container (type is then the container's name, and member is "").
+// offset is the stream's position (tellp when saving, tellg when loading)
+// or -1 if the stream cannot tell.
+//
+// The observer for a stream type S is ArchiveObserver<S>::type.  It is
+// XMLSERIAL_OBSERVER for all streams unless ArchiveObserver is specialized;
+// defining XMLSERIAL_OBSERVER (before any xmlserial header) sets it for
+// all.  The default, nullobserver, compiles to nothing.
+
+#ifndef XMLSERIAL_OBSERVER
+#define XMLSERIAL_OBSERVER XMLSERIALNAMESPACE::nullobserver
+#endif
+
+// (S is the type of the stream s)
+#define XMLSERIAL_OBSERVE_SAVE(S,tname,mname,s) \
+	XMLSERIALNAMESPACE::ObserveScope<S,true, \
+		typename XMLSERIALNAMESPACE::ArchiveObserver<S>::type> \
+			xmlserial_obsscope(tname,mname,s)
+#define XMLSERIAL_OBSERVE_LOAD(S,tname,mname,s) \
+	XMLSERIALNAMESPACE::ObserveScope<S,false, \
+		typename XMLSERIALNAMESPACE::ArchiveObserver<S>::type> \
+			xmlserial_obsscope(tname,mname,s)
+
+namespace XMLSERIALNAMESPACE {
+
+	struct nullobserver {
+		static void on_begin(const char *, const char *, long long) {}
+		static void on_end(const char *, const char *, long long) {}
+	};
+
+	template<typename S>
+	struct ArchiveObserver {
+		typedef XMLSERIAL_OBSERVER type;
+	};
+
+	// the position of stream s (or -1), when saving (SAVE) or loading
+	// (not asking a stream that is not good, as that would set fail)
+	template<typename S, bool SAVE>
+	struct StreamPos {
+		static long long get(S &s) {
+			return s.good() ? (long long)std::streamoff(s.tellp()) : -1;
+		}
+	};
+	template<typename S>
+	struct StreamPos<S,false> {
+		static long long get(S &s) {
+			return s.good() ? (long long)std::streamoff(s.tellg()) : -1;
+		}
+	};
+
+	// the class name of O (a class or a pointer to one)
+	template<typename O>
+	struct OwnerName {
+		static const char *name() { return O::xmlserial_IDname(); }
+	};
+	template<typename T>
+	struct OwnerName<T *> {
+		static const char *name() { return T::xmlserial_IDname(); }
+	};
+	template<typename T>
+	struct OwnerName<const T *> {
+		static const char *name() { return T::xmlserial_IDname(); }
+	};
+
+	// calls the observer Obs at the start and end of its lifetime
+	template<typename S, bool SAVE, typename Obs>
+	class ObserveScope {
+	public:
+		ObserveScope(const char *type, const char *member, S &s)
+				: t(type), m(member), st(s) {
+			Obs::on_begin(t,m,StreamPos<S,SAVE>::get(st));
+		}
+		~ObserveScope() {
+			Obs::on_end(t,m,StreamPos<S,SAVE>::get(st));
+		}
+	private:
+		const char *t, *m;
+		S &st;
+	};
+
+	template<typename S, bool SAVE>
+	class ObserveScope<S,SAVE,nullobserver> {
+	public:
+		ObserveScope(const char *, const char *, S &) {}
+	};
+}
+
+#endif // of file guard
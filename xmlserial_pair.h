@@ -50,7 +50,7 @@ namespace XMLSERIALNAMESPACE {
 				S &os,int indent,
 				const char *firstname= "first",
 				const char *secondname="second") {
-			os << std::endl;
+			os << '\n';
 			XMLTagInfo firstfields;
 			firstfields.attr["name"] = firstname;
 			SaveWrapper(p.first,firstfields,os,indent+1);
@@ -66,6 +66,8 @@ namespace XMLSERIALNAMESPACE {
 					: p(pa), s1(n1), s2(n2) {}
 				std::pair<T1,T2> &p;
 				const char *s1,*s2;
+				// (for the observers and profiler)
+				static const char *xmlserial_IDname() { return "pair"; }
 		};
 
 		struct Get1 {
@@ -110,11 +112,12 @@ namespace XMLSERIALNAMESPACE {
 				const char *firstname="first",
 				const char *secondname="second") {
 			std::ostringstream ss1;
+			XMLSERIAL_COUNT(stringstreams,2);
 			dupfmt(ss1,os);
-			ss1 << p.first;
+			WriteNum(ss1,p.first);
 			std::ostringstream ss2;
 			dupfmt(ss2,os);
-			ss2 << p.second;
+			WriteNum(ss2,p.second);
 			fields.attr[firstname] = ss1.str();
 			fields.attr[secondname] = ss2.str();
 		}
@@ -136,6 +139,7 @@ namespace XMLSERIALNAMESPACE {
 				=info.attr.find(firstname);
 			if (vi!=info.attr.end()) {
 				std::istringstream ss(vi->second);
+				XMLSERIAL_COUNT(stringstreams,1);
 				dupfmt(ss,is);
 				ss >> p.first;
 			} else
@@ -143,6 +147,7 @@ namespace XMLSERIALNAMESPACE {
 			vi = info.attr.find(secondname);
 			if (vi!=info.attr.end()) {
 				std::istringstream ss(vi->second);
+				XMLSERIAL_COUNT(stringstreams,1);
 				dupfmt(ss,is);
 				ss >> p.second;
 			} else
@@ -0,0 +1,317 @@
+/* By Christian R. Shelton
+ * (christian.r.shelton@gmail.com)
+ * August 2014
+ *   [original release]
+ *
+ * Released under MIT software licence:
+ * The MIT License (MIT)
+ * Copyright (c) 2014 Christian R. Shelton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef XMLSERIAL_PROFILE_H
+#define XMLSERIAL_PROFILE_H
+
+// Profiling:  compiled with XMLSERIAL_PROFILE defined (before any
+// xmlserial header), saving and loading time each class object and each
+// class member, and count the bytes of the stream each covers.  Times are
+// kept in processor ticks (rdtsc, where there is one) and added up in a
+// table for each thread, keyed by class name and member name, with both
+// inclusive time and exclusive time (less the time of the objects and
+// members within).
+//
+//    xmlserial::Profile().report(std::cerr);   // table, by exclusive time
+//    xmlserial::Profile().clear();
+//
+// Profile().trace(true) also records every scope as an event, and
+// Profile().chrometrace(os) writes them as Chrome trace-event JSON (for
+// chrome://tracing, Perfetto, or speedscope).  Each thread's profile
+// holds what that thread did.
+//
+// Without XMLSERIAL_PROFILE, the scopes compile to nothing.
+
+#ifdef XMLSERIAL_PROFILE
+
+#include <map>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+#include <ctime>
+#if __cplusplus > 199711L
+#include <chrono>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define XMLSERIAL_HAS_TSC
+#endif
+
+// (S is the type of the stream s)
+#define XMLSERIAL_PROFILE_SAVE(S,cname,mname,s) \
+	XMLSERIALNAMESPACE::ProfileScope<S,true> \
+		xmlserial_profscope(cname,mname,s)
+#define XMLSERIAL_PROFILE_LOAD(S,cname,mname,s) \
+	XMLSERIALNAMESPACE::ProfileScope<S,false> \
+		xmlserial_profscope(cname,mname,s)
+
+namespace XMLSERIALNAMESPACE {
+
+	typedef unsigned long long proftick;
+
+	inline proftick ProfileTicks() {
+#ifdef XMLSERIAL_HAS_TSC
+		return __rdtsc();
+#elif __cplusplus > 199711L
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+		return clock();
+#endif
+	}
+
+#ifdef XMLSERIAL_HAS_TSC
+	// ticks per second, measured over about 20ms
+	inline double MeasureTickRate() {
+#if __cplusplus > 199711L
+		typedef std::chrono::steady_clock clk;
+		clk::time_point t0 = clk::now();
+		proftick k0 = ProfileTicks();
+		while(clk::now()-t0 < std::chrono::milliseconds(20)) ;
+		double dt = std::chrono::duration<double>(clk::now()-t0).count();
+#else
+		clock_t t0 = clock();
+		proftick k0 = ProfileTicks();
+		while(clock()-t0 < CLOCKS_PER_SEC/50) ;
+		double dt = double(clock()-t0)/CLOCKS_PER_SEC;
+#endif
+		return (ProfileTicks()-k0)/dt;
+	}
+#endif
+
+	// ticks per second (measured once, for rdtsc, as a static initialized
+	// by MeasureTickRate, so threads profiling at once measure it once)
+	inline double ProfileTickRate() {
+#ifdef XMLSERIAL_HAS_TSC
+		static double rate = MeasureTickRate();
+		return rate;
+#elif __cplusplus > 199711L
+		return 1e9;
+#else
+		return CLOCKS_PER_SEC;
+#endif
+	}
+
+	class profiler {
+	public:
+		profiler() : tracing(false) {}
+
+		struct entry {
+			entry() : calls(0), incl(0), excl(0), bytes(0) {}
+			unsigned long long calls;
+			proftick incl, excl;
+			unsigned long long bytes;
+		};
+
+		// record each scope as an event too (for chrometrace)
+		void trace(bool on) { tracing = on; }
+
+		void clear() {
+			table.clear();
+			events.clear();
+			open.clear();
+		}
+
+		void begin(proftick now) {
+			open.push_back(now);
+			open.push_back(0); // time in scopes within
+		}
+
+		void end(const char *cname, const char *mname, const char *phase,
+				proftick start, long long bytes) {
+			proftick now = ProfileTicks();
+			proftick t = now-start;
+			proftick inner = open.back();
+			open.pop_back();
+			open.pop_back();
+			if (!open.empty()) open.back() += t;
+			entry &e = table[key(cname,mname,phase)];
+			e.calls++;
+			e.incl += t;
+			e.excl += t-inner;
+			if (bytes>0) e.bytes += bytes;
+			if (tracing) {
+				event ev;
+				ev.cname = cname;
+				ev.mname = mname;
+				ev.phase = phase;
+				ev.start = start;
+				ev.dur = t;
+				events.push_back(ev);
+			}
+		}
+
+		// the table, by exclusive time (largest first)
+		template<typename S>
+		void report(S &os) const {
+			// the same names may come from different pointers
+			std::map<std::string,entry> merged;
+			for(typename tableT::const_iterator i=table.begin();
+					i!=table.end();++i) {
+				entry &m = merged[name(i->first)];
+				m.calls += i->second.calls;
+				m.incl += i->second.incl;
+				m.excl += i->second.excl;
+				m.bytes += i->second.bytes;
+			}
+			std::vector<std::pair<proftick,std::string> > order;
+			for(std::map<std::string,entry>::const_iterator i=merged.begin();
+					i!=merged.end();++i)
+				order.push_back(std::make_pair(i->second.excl,i->first));
+			std::sort(order.rbegin(),order.rend());
+			double ms = 1e3/ProfileTickRate();
+			os << std::setw(12) << "excl ms" << std::setw(12) << "incl ms"
+				<< std::setw(12) << "calls" << std::setw(14) << "bytes"
+				<< "  name\n";
+			for(std::size_t i=0;i<order.size();i++) {
+				const entry &e = merged[order[i].second];
+				os << std::fixed << std::setprecision(3)
+					<< std::setw(12) << e.excl*ms
+					<< std::setw(12) << e.incl*ms
+					<< std::setw(12) << e.calls
+					<< std::setw(14) << e.bytes
+					<< "  " << order[i].second << '\n';
+			}
+		}
+
+		// the events recorded (with trace(true)) as Chrome trace JSON
+		template<typename S>
+		void chrometrace(S &os, int tid=1) const {
+			double us = 1e6/ProfileTickRate();
+			proftick t0 = events.empty() ? 0 : events[0].start;
+			for(std::size_t i=0;i<events.size();i++)
+				if (events[i].start<t0) t0 = events[i].start;
+			os << "{\"traceEvents\":[";
+			for(std::size_t i=0;i<events.size();i++) {
+				const event &ev = events[i];
+				os << (i ? ",\n" : "\n") << "{\"name\":\"";
+				JSONStr(os,name(key(ev.cname,ev.mname,ev.phase)));
+				os << "\",\"cat\":\"" << ev.phase
+					<< "\",\"ph\":\"X\",\"ts\":" << std::fixed
+					<< std::setprecision(3) << (ev.start-t0)*us
+					<< ",\"dur\":" << ev.dur*us
+					<< ",\"pid\":1,\"tid\":" << tid << '}';
+			}
+			os << "\n]}\n";
+		}
+
+	private:
+		struct keyT {
+			const char *cname, *mname, *phase;
+			bool operator<(const keyT &k) const {
+				std::less<const char *> lt;
+				if (cname!=k.cname) return lt(cname,k.cname);
+				if (mname!=k.mname) return lt(mname,k.mname);
+				return lt(phase,k.phase);
+			}
+		};
+		static keyT key(const char *c, const char *m, const char *p) {
+			keyT k;
+			k.cname = c;
+			k.mname = m;
+			k.phase = p;
+			return k;
+		}
+		// "save Class.member" (or "save Class" for a whole object)
+		static std::string name(const keyT &k) {
+			std::string ret(k.phase);
+			ret += ' ';
+			ret += k.cname;
+			if (*k.mname) {
+				ret += '.';
+				ret += k.mname;
+			}
+			return ret;
+		}
+		template<typename S>
+		static void JSONStr(S &os, const std::string &s) {
+			for(std::size_t i=0;i<s.length();i++) {
+				if (s[i]=='"' || s[i]=='\\') os << '\\';
+				if ((unsigned char)s[i]>=' ') os << s[i];
+			}
+		}
+
+		struct event {
+			const char *cname, *mname, *phase;
+			proftick start, dur;
+		};
+
+		typedef std::map<keyT,entry> tableT;
+		tableT table;
+		std::vector<event> events;
+		std::vector<proftick> open; // start, inner time for each open scope
+		bool tracing;
+	};
+
+	// this thread's profile
+	inline profiler &Profile() {
+#if __cplusplus > 199711L
+		static thread_local profiler p;
+#else
+		static profiler p;
+#endif
+		return p;
+	}
+
+	// times (and counts the bytes of) its own lifetime
+	template<typename S, bool SAVE>
+	class ProfileScope {
+	public:
+		ProfileScope(const char *cname, const char *mname, S &s)
+				: c(cname), m(mname), st(s),
+				pos(StreamPos<S,SAVE>::get(s)) {
+			Profile().begin(start = ProfileTicks());
+		}
+		~ProfileScope() {
+			long long end = pos<0 ? -1 : StreamPos<S,SAVE>::get(st);
+			Profile().end(c,m,SAVE ? "save" : "load",start,
+				end>=pos ? end-pos : 0);
+		}
+	private:
+		const char *c, *m;
+		S &st;
+		long long pos;
+		proftick start;
+	};
+}
+
+#else
+
+#define XMLSERIAL_PROFILE_SAVE(S,cname,mname,s)
+#define XMLSERIAL_PROFILE_LOAD(S,cname,mname,s)
+
+#endif
+
+#endif // of file guard
@@ -0,0 +1,297 @@
+/* By Christian R. Shelton
+ * (christian.r.shelton@gmail.com)
+ * August 2014
+ *   [original release]
+ *
+ * Released under MIT software licence:
+ * The MIT License (MIT)
+ * Copyright (c) 2014 Christian R. Shelton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef XMLSERIAL_PROJECT_H
+#define XMLSERIAL_PROJECT_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+#include <cstdlib>
+#if __cplusplus > 199711L
+#include <initializer_list>
+#endif
+#include "xmlserial.h"
+#include "xmlserial_skip.h"
+
+// Projection loads:  LoadOnly(obj,is,paths) loads only the members of obj
+// named by paths, each a list of member names separated by dots:
+//
+//    xmlserial::LoadOnly(rec,is,{"header.timestamp","payload.id"});
+//
+// A path that ends at a member loads all of that member.  Every other
+// member is skipped (with SkipElement) without being parsed.  Members
+// missing from the input are left as they were (no exception is thrown,
+// and no defaults are set), and neither preload nor postload is run.
+//
+// Paths go through class members and base classes (named by their class
+// names).  A vector, deque or list of classes passes the rest of the path
+// on to each of its elements, so {"id"} loads just the ids of a
+// vector<Rec>.  A path that continues into anything else (a pointer, say)
+// loads all of it.
+//
+// With an archive, pointed-to objects and strings of the string table are
+// written in full only the first time, so a member that is skipped must
+// not be the first to hold one:  LoadOnly throws a streamexception if it
+// is.  (Members skipped after the one holding it, which only refer to it,
+// are fine.)
+
+namespace XMLSERIALNAMESPACE {
+
+	// a set of member paths
+	class projection {
+	public:
+		projection() : whole(false) {}
+		projection(const std::vector<std::string> &paths) : whole(false) {
+			for(std::size_t i=0;i<paths.size();i++) add(paths[i]);
+		}
+#if __cplusplus > 199711L
+		projection(std::initializer_list<std::string> paths)
+				: whole(false) {
+			for(const std::string &p : paths) add(p);
+		}
+#endif
+
+		projection &add(const std::string &path) {
+			projection *p = this;
+			std::size_t b = 0;
+			while(!p->whole) {
+				std::size_t e = path.find('.',b);
+				p = &p->sub[path.substr(b,e==std::string::npos ? e : e-b)];
+				if (e==std::string::npos) {
+					p->whole = true;
+					p->sub.clear();
+				}
+				b = e+1;
+			}
+			return *this;
+		}
+
+		// is all of it to be loaded?
+		bool iswhole() const { return whole; }
+		// the paths within member name (0 if it is not to be loaded)
+		const projection *member(const std::string &name) const {
+			std::map<std::string,projection>::const_iterator i
+				= sub.find(name);
+			return i==sub.end() ? 0 : &i->second;
+		}
+
+	private:
+		bool whole;
+		std::map<std::string,projection> sub;
+	};
+
+	// skips the element of a member that is not to be loaded (its start
+	// tag, info, has been read)
+	template<typename S>
+	inline void ProjectSkip(S &is, const XMLTagInfo &info) {
+		SkipElement(is,info);
+	}
+
+	// (in an archive, checking that nothing the rest of the archive may
+	// refer to is skipped)
+	class projectskipcheck {
+	public:
+		projectskipcheck(const archive &ar) : ar(ar) {}
+		// the start tag of an element inside the skipped one
+		void operator()(const std::string &tag) const {
+			std::size_t p = tag.find(" ptrid=\"");
+			check(tag.find(" sid=\"")!=std::string::npos,
+				p==std::string::npos ? 0 : tag.c_str()+p+8,
+				tag.find(" xshard=\"")!=std::string::npos,tag);
+		}
+		// the skipped element's own start tag
+		void operator()(const XMLTagInfo &info) const {
+			std::map<std::string,std::string>::const_iterator
+				p = info.attr.find("ptrid");
+			check(info.attr.count("sid")!=0,
+				p==info.attr.end() ? 0 : p->second.c_str(),
+				info.attr.count("xshard")!=0,"<"+info.name+">");
+		}
+	private:
+		// throws if the tag (with string id, pointer id ptrid, or a
+		// pointer to another shard) is the first to hold something
+		void check(bool sid, const char *ptrid, bool xshard,
+				const std::string &tag) const {
+			if (sid || (ptrid && !xshard && !ar.validid(atoi(ptrid))))
+				throw streamexception(std::string("Stream Input Format Error: LoadOnly cannot skip ")+tag+", the first to hold a pointed-to object or string of the archive");
+		}
+		const archive &ar;
+	};
+
+	inline void ProjectSkip(archive &is, const XMLTagInfo &info) {
+		projectskipcheck check(is);
+		check(info);
+		SkipElement(is,info,0,check);
+	}
+
+	// is T followed member by member?
+	template<typename T>
+	struct IsProjectClass {
+		enum { value = TypeProp<T>::HasIDname && !PtrInfo<T>::isptr };
+	};
+
+	template<typename L>
+	struct ProjectItt;
+
+	// loads what p selects of t, whose start tag (info) has been read
+	template<typename T,typename Condition=void>
+	struct ProjectMember {
+		template<typename S>
+		inline static void load(T &t, const XMLTagInfo &info, S &is,
+				const projection &) {
+			LoadWrapper(t,info,is);
+		}
+	};
+
+	template<typename T>
+	struct ProjectMember<T,
+			typename Type_If<IsProjectClass<T>::value,void>::type> {
+		template<typename S>
+		inline static void load(T &t, const XMLTagInfo &info, S &is,
+				const projection &p) {
+			if (p.iswhole()) {
+				LoadWrapper(t,info,is);
+				return;
+			}
+			CheckTag<T>::check(info);
+			if (info.isend) return;
+			const char *cname = TypeInfo<T>::namestr();
+			XMLTagInfo minfo;
+			while(1) {
+				ReadTag(is,minfo);
+				if (minfo.isend && !minfo.isstart) {
+					if (minfo.name != cname)
+						throw streamexception(std::string("Stream Input Format Error: expected end tag for ")+cname+", received end tag for "+minfo.name);
+					return;
+				}
+				if (!ProjectItt<typename T::xmlserial_alllist>::load(&t,is,minfo,p))
+					ProjectSkip(is,minfo);
+			}
+		}
+	};
+
+	// sequences of classes:  p applies to each element
+	template<typename C>
+	struct ProjectSeq {
+		template<typename S>
+		inline static void load(C &c, const XMLTagInfo &info, S &is,
+				const projection &p) {
+			if (p.iswhole()) {
+				LoadWrapper(c,info,is);
+				return;
+			}
+			CheckTag<C>::check(info);
+			c.clear();
+			if (info.isend) return;
+			const char *cname = TypeInfo<C>::namestr();
+			XMLTagInfo einfo;
+			while(1) {
+				ReadTag(is,einfo);
+				if (einfo.isend && !einfo.isstart) {
+					if (einfo.name != cname)
+						throw streamexception(std::string("Stream Input Format Error: expected end tag for ")+cname+", received end tag for "+einfo.name);
+					return;
+				}
+				c.push_back(typename C::value_type());
+				ProjectMember<typename C::value_type>::load(c.back(),
+					einfo,is,p);
+			}
+		}
+	};
+
+	template<typename T, typename A>
+	struct ProjectMember<std::vector<T,A>,
+			typename Type_If<IsProjectClass<T>::value,void>::type>
+		: public ProjectSeq<std::vector<T,A> > { };
+	template<typename T, typename A>
+	struct ProjectMember<std::deque<T,A>,
+			typename Type_If<IsProjectClass<T>::value,void>::type>
+		: public ProjectSeq<std::deque<T,A> > { };
+	template<typename T, typename A>
+	struct ProjectMember<std::list<T,A>,
+			typename Type_If<IsProjectClass<T>::value,void>::type>
+		: public ProjectSeq<std::list<T,A> > { };
+
+	// finds the member of o for tag info (returning false if none) and
+	// loads what p selects of it
+	template<typename L>
+	struct ProjectItt {
+		template<typename O, typename S>
+		inline static bool load(O, S &, const XMLTagInfo &,
+				const projection &) {
+			return false;
+		}
+	};
+
+	template<typename H, typename T>
+	struct ProjectItt<List<H,T> > {
+		typedef typename H::valtype V;
+
+		template<typename O, typename S>
+		inline static bool load(O o, S &is, const XMLTagInfo &info,
+				const projection &p) {
+			if (!IsEmpty<V>::value) {
+				std::map<std::string,std::string>::const_iterator ai
+					= info.attr.find("mid");
+				if (ai!=info.attr.end()) {
+					if (strtol(ai->second.c_str(),0,10)==MemberId<H,T>::id())
+						return loadmember(o,is,info,p);
+				} else {
+					ai = info.attr.find("name");
+					if (ai!=info.attr.end() && ai->second==H::getname(o))
+						return loadmember(o,is,info,p);
+				}
+			}
+			return ProjectItt<T>::load(o,is,info,p);
+		}
+
+		template<typename O, typename S>
+		inline static bool loadmember(O o, S &is, const XMLTagInfo &info,
+				const projection &p) {
+			const projection *m = p.member(H::getname(o));
+			if (m) ProjectMember<V>::load(H::getvalue(o),info,is,*m);
+			else ProjectSkip(is,info);
+			return true;
+		}
+	};
+
+	// loads only the members of t that p selects
+	template<typename T, typename S>
+	void LoadOnly(T &t, S &is, const projection &p) {
+		StatsRead<S> count(is);
+		XMLTagInfo info;
+		ReadTag(is,info);
+		ProjectMember<T>::load(t,info,is,p);
+	}
+
+}
+
+#endif // of file guard
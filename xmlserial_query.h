@@ -0,0 +1,248 @@
+/* By Christian R. Shelton
+ * (christian.r.shelton@gmail.com)
+ * August 2014
+ *   [original release]
+ *
+ * Released under MIT software licence:
+ * The MIT License (MIT)
+ * Copyright (c) 2014 Christian R. Shelton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef XMLSERIAL_QUERY_H
+#define XMLSERIAL_QUERY_H
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include "xmlserial.h"
+#include "xmlserial_skip.h"
+
+// Path queries:  reading a stream without knowing the types written to
+// it, Query(is,q,f) calls f for each element that matches the path q.
+//
+// A path is a list of steps separated by /, each matching one level of
+// nesting, starting with the top-level elements:
+//
+//    tag        an element with that tag (* or nothing matches any)
+//    tag@name   one that also has that name attribute (@name for any tag)
+//    **         any number of levels (including none)
+//
+// So "Portfolio/@holdings/**/@price" finds every member called price
+// anywhere within the member holdings of a top-level Portfolio.
+//
+// The stream is read once, and only the elements being looked within are
+// kept (so memory does not grow with the size of the input).  Elements
+// that cannot hold a match are skipped with SkipElement, without being
+// parsed.  The stream may hold any number of top-level elements.
+
+namespace XMLSERIALNAMESPACE {
+
+	class pathquery {
+	public:
+		pathquery() {}
+		pathquery(const std::string &path) { parse(path); }
+
+		// throws streamexception if path is not a path
+		void parse(const std::string &path) {
+			steps.clear();
+			std::size_t b = 0;
+			while(b<=path.length()) {
+				std::size_t e = path.find('/',b);
+				if (e==std::string::npos) e = path.length();
+				std::string s = path.substr(b,e-b);
+				b = e+1;
+				if (s.empty()) continue;
+				step st;
+				if (s=="**") st.any = true;
+				else {
+					std::size_t at = s.find('@');
+					st.tag = s.substr(0,at);
+					if (st.tag=="*") st.tag.clear();
+					if (at!=std::string::npos) {
+						st.hasname = true;
+						st.name = s.substr(at+1);
+					}
+				}
+				steps.push_back(st);
+			}
+			if (steps.empty() || steps.back().any)
+				throw streamexception(std::string("Query Error: path ")+path+" does not end with a tag");
+		}
+
+		// for an element (info) within one with steps [b,e) of states
+		// still to match, appends to states the steps still to match
+		// within it, returning true if it matches the whole path
+		bool advance(std::vector<int> &states, std::size_t b,
+				std::size_t e, const XMLTagInfo &info) const {
+			bool matched = false;
+			for(;b!=e;++b) matched |= match(states[b],info,states);
+			return matched;
+		}
+
+		int start() const { return 0; }
+
+	private:
+		struct step {
+			step() : any(false), hasname(false) {}
+			bool any, hasname;
+			std::string tag, name;
+		};
+		std::vector<step> steps;
+
+		bool match(int s, const XMLTagInfo &info,
+				std::vector<int> &next) const {
+			const step &st = steps[s];
+			if (st.any) {
+				add(next,s);
+				return match(s+1,info,next);
+			}
+			if (!st.tag.empty() && st.tag!=info.name) return false;
+			if (st.hasname) {
+				std::map<std::string,std::string>::const_iterator ni
+					= info.attr.find("name");
+				if (ni==info.attr.end() || ni->second!=st.name)
+					return false;
+			}
+			if (s+1==(int)steps.size()) return true;
+			add(next,s+1);
+			return false;
+		}
+
+		// (next holds a -1 before the steps of the element being added)
+		static void add(std::vector<int> &next, int s) {
+			for(std::size_t i=next.size();i>0 && next[i-1]>=0;i--)
+				if (next[i-1]==s) return;
+			next.push_back(s);
+		}
+	};
+
+	// an element matched by a query
+	struct querymatch {
+		querymatch(const XMLTagInfo &i, const std::string &v, bool c,
+				const std::vector<std::string> &p)
+			: info(i), value(v), haschildren(c), path(p) {}
+
+		const XMLTagInfo &info; // its start tag
+		// its value attribute, or its text (unescaped) if it has no
+		// elements within it (empty otherwise)
+		const std::string &value;
+		bool haschildren;
+		// the tags of the elements it is within, and its own (each as
+		// tag@name if it has a name)
+		const std::vector<std::string> &path;
+	};
+
+	// calls f(m) (m a querymatch) for each element of is that matches q,
+	// returning the number
+	template<typename S, typename F>
+	std::size_t Query(S &is, const pathquery &q, F &f) {
+		std::size_t nmatch = 0;
+		// the steps still to match within each open element (after a -1)
+		std::vector<int> states(1,-1);
+		states.push_back(q.start());
+		std::vector<std::size_t> frames(1,0); // where each one's start
+		std::vector<std::string> tags, path;
+		XMLTagInfo info, einfo;
+		std::string value;
+		bool pending = false; // has info been read but not handled?
+		while(1) {
+			if (!pending) {
+				if (!SkipTo(is,'<',0)) {
+					if (tags.empty()) return nmatch;
+					throw streamexception("Stream Input Format Error: unexpected stream end");
+				}
+				ReadTag(is,info);
+			}
+			pending = false;
+			if (info.isend && !info.isstart) {
+				if (tags.empty() || info.name!=tags.back())
+					throw streamexception(std::string("Stream Input Format Error: unexpected end tag for ")+info.name);
+				states.resize(frames.back());
+				frames.pop_back();
+				tags.pop_back();
+				path.pop_back();
+				continue;
+			}
+			std::size_t here = states.size();
+			states.push_back(-1);
+			bool matched = q.advance(states,frames.back()+1,here,info);
+			bool within = states.size()>here+1;
+			std::map<std::string,std::string>::const_iterator ni
+				= info.attr.find("name");
+			path.push_back(ni==info.attr.end() ? info.name
+					: info.name+"@"+ni->second);
+			bool open = !info.isend;
+			if (matched) {
+				nmatch++;
+				std::map<std::string,std::string>::const_iterator vi
+					= info.attr.find("value");
+				bool children = false;
+				value.clear();
+				if (vi!=info.attr.end()) {
+					if (info.name=="string") {
+						// (whose value attributes are escaped twice)
+						std::istringstream ss(vi->second);
+						ReadStr(ss,value,"");
+					} else value = vi->second;
+				}
+				if (open) {
+					if (vi==info.attr.end()) ReadText(is,value);
+					else SkipTo(is,'<',0);
+					ReadTag(is,einfo);
+					if (!einfo.isend || einfo.isstart) {
+						children = true;
+						value.clear();
+					} else if (einfo.name!=info.name)
+						throw streamexception(std::string("Stream Input Format Error: expected end tag for ")+info.name+", received end tag for "+einfo.name);
+					else open = false;
+				}
+				querymatch m(info,value,children,path);
+				f(m);
+				if (children) {
+					if (within) {
+						// (einfo is the first element within it)
+						frames.push_back(here);
+						tags.push_back(info.name);
+						info = einfo;
+						pending = true;
+						continue;
+					}
+					SkipElement(is,einfo);
+					SkipElement(is,info);
+					open = false;
+				}
+			} else if (open && !within) {
+				SkipElement(is,info);
+				open = false;
+			}
+			if (open) {
+				frames.push_back(here);
+				tags.push_back(info.name);
+			} else {
+				states.resize(here);
+				path.pop_back();
+			}
+		}
+	}
+
+}
+
+#endif // of file guard
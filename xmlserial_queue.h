@@ -44,7 +44,7 @@ namespace XMLSERIALNAMESPACE {
 		inline static bool isinline(const std::queue<T,C> &) { return false; }
 		template<typename S>
 		inline static void save(const std::queue<T,C> q, S &os,int indent) {
-			os << std::endl;
+			os << '\n';
 			XMLTagInfo fields;
 			SaveWrapper(getcontainer<std::queue<T,C> >::get(q),fields,os,indent+1);
 			Indent(os,indent);
@@ -68,7 +68,7 @@ namespace XMLSERIALNAMESPACE {
 		inline static bool isinline(const std::priority_queue<T,C,P> &) { return false; }
 		template<typename S>
 		inline static void save(const std::priority_queue<T,C,P> q, S &os,int indent) {
-			os << std::endl;
+			os << '\n';
 			XMLTagInfo fields;
 			SaveWrapper(getcontainer<std::priority_queue<T,C,P> >::get(q),fields,os,indent+1);
 			Indent(os,indent);
@@ -0,0 +1,304 @@
+/* By Christian R. Shelton
+ * (christian.r.shelton@gmail.com)
+ * August 2014
+ *   [original release]
+ *
+ * Released under MIT software licence:
+ * The MIT License (MIT)
+ * Copyright (c) 2014 Christian R. Shelton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef XMLSERIAL_RECORDS_H
+#define XMLSERIAL_RECORDS_H
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include "xmlserial.h"
+#include "xmlserial_archive.h"
+
+// Record streams:  many independent objects, one after another, each
+// framed with its length, as in
+//
+//    <record len="52"><Trade>...<\Trade>
+//    <\record>
+//    <record len="61">...
+//
+// where len is the number of characters between the > and the <\record>.
+// A recordwriter ends the stream (unless asked not to) with an index of
+// where each record starts,
+//
+//    <recordindex nelem="2" end="130">0 72 <\recordindex>
+//    <recordindexat offset="00000000000000000130" \>
+//
+// whose last line has a fixed length, so that a recordreader can find
+// the index from the end of the stream.  The index can also be written to
+// a stream of its own (a "sidecar" file).  Without an index, a reader
+// builds one by reading the record tags only, jumping over the records.
+//
+// Offsets count from where the writer started (and where the reader
+// started).  Each record is saved with an archive of its own, so pointers
+// shared within a record stay shared, but none are shared between
+// records.
+
+namespace XMLSERIALNAMESPACE {
+
+	// the fixed-length last line of a stream with an index
+	struct RecordFooter {
+		static const char *prefix() { return "<recordindexat offset=\""; }
+		static const char *suffix() { return "\" \\>\n"; }
+		enum { ndigits = 20 };
+		static std::size_t length() {
+			return std::strlen(prefix())+ndigits+std::strlen(suffix());
+		}
+	};
+
+	class recordwriter {
+	public:
+		// with withindex false, close() writes no index
+		recordwriter(std::ostream &output, bool withindex=true)
+			: os(&output), at(0), index(withindex), closed(false) {}
+		~recordwriter() { close(); }
+
+		// saves t as the next record, returning its number
+		template<typename T>
+		std::size_t append(const T &t) {
+			std::ostringstream ss;
+			dupfmt(ss,*os);
+			{
+				archive a(ss);
+				Save(t,a);
+			}
+			std::string body = ss.str();
+			std::string head = "<record len=\""+T2str(body.size())+"\">";
+			offs.push_back(at);
+			os->write(head.data(),head.size());
+			os->write(body.data(),body.size());
+			os->write("<\\record>\n",10);
+			XMLSERIAL_COUNT(tags_written,2);
+			at += std::streamoff(head.size()+body.size()+10);
+			return offs.size()-1;
+		}
+
+		// the number of records written
+		std::size_t size() const { return offs.size(); }
+		// where record n starts
+		std::streamoff offset(std::size_t n) const { return offs[n]; }
+
+		// writes the index to out (for a sidecar file)
+		void writeindex(std::ostream &out) const {
+			out << "<recordindex nelem=\"" << offs.size() << "\" end=\""
+				<< at << "\">";
+			for(std::size_t i=0;i<offs.size();i++)
+				out << offs[i] << ' ';
+			out << "<\\recordindex>\n";
+			XMLSERIAL_COUNT(tags_written,2);
+		}
+
+		// ends the stream (with the index, if withindex); nothing
+		// more can be appended
+		void close() {
+			if (closed) return;
+			closed = true;
+			if (!index) return;
+			writeindex(*os);
+			std::string n = T2str(at);
+			*os << RecordFooter::prefix()
+				<< std::string(RecordFooter::ndigits-n.length(),'0')
+				<< n << RecordFooter::suffix();
+			os->flush();
+		}
+
+	private:
+		std::ostream *os;
+		std::vector<std::streamoff> offs;
+		std::streamoff at;
+		bool index, closed;
+	};
+
+	// reads the records written by a recordwriter.  next() reads them in
+	// order from any stream; the rest need a stream that can seek.
+	class recordreader {
+	public:
+		recordreader(std::istream &input) : is(&input), n(0),
+				indexed(false), end(0) {
+			base = is->tellg();
+			if (base<0) base = 0;
+		}
+
+		// reads the index from idx (a sidecar file), instead of from the
+		// end of the stream
+		void readindex(std::istream &idx) {
+			XMLTagInfo info;
+			ReadTag(idx,info);
+			if (info.name!="recordindex" || !info.isstart || info.isend)
+				throw streamexception("Stream Input Format Error: expected start tag for recordindex, received tag for "+info.name);
+			std::size_t nelem = std::strtoul(info.attr["nelem"].c_str(),0,10);
+			offs.resize(nelem);
+			for(std::size_t i=0;i<nelem;i++)
+				if (!(idx >> offs[i]))
+					throw streamexception("Stream Input Format Error: recordindex too short");
+			end = std::strtol(info.attr["end"].c_str(),0,10);
+			ReadEndTag(idx,"recordindex");
+			indexed = true;
+		}
+
+		// the number of records
+		std::size_t size() { buildindex(); return offs.size(); }
+		// where record i starts
+		std::streamoff offset(std::size_t i) {
+			buildindex();
+			return offs[i];
+		}
+		// the number of the record next() reads
+		std::size_t pos() const { return n; }
+
+		// moves to record i
+		void seek(std::size_t i) {
+			buildindex();
+			if (i>offs.size())
+				throw streamexception("Stream Input Error: no record "+T2str(i));
+			is->clear();
+			is->seekg(base+(i<offs.size() ? offs[i] : end));
+			n = i;
+		}
+
+		// reads the next record into t (returning false, and leaving t
+		// alone, if there are no more)
+		template<typename T>
+		bool next(T &t) {
+			std::streamoff len;
+			if (!readhead(len)) return false;
+			archive a(*is);
+			Load(t,a);
+			ReadEndTag(*is,"record");
+			n++;
+			return true;
+		}
+
+		// reads record i into t
+		template<typename T>
+		void read(std::size_t i, T &t) {
+			seek(i);
+			if (!next(t))
+				throw streamexception("Stream Input Error: no record "+T2str(i));
+		}
+
+		// splits the records into (at most) k ranges of consecutive
+		// records [first,second) of about the same number of characters,
+		// for reading in parallel (each with its own stream and reader,
+		// which seeks to first)
+		std::vector<std::pair<std::size_t,std::size_t> > split(std::size_t k) {
+			buildindex();
+			std::vector<std::pair<std::size_t,std::size_t> > ret;
+			std::size_t b = 0;
+			for(std::size_t j=1;j<=k && b<offs.size();j++) {
+				std::size_t e = j==k ? offs.size()
+					: std::lower_bound(offs.begin()+b,offs.end(),
+						std::streamoff(end/double(k)*j))-offs.begin();
+				if (e>b) {
+					ret.push_back(std::make_pair(b,e));
+					b = e;
+				}
+			}
+			return ret;
+		}
+
+	private:
+		// reads the start tag of the next record (false if there are no
+		// more)
+		bool readhead(std::streamoff &len) {
+			IgnoreWS(*is);
+			if (is->peek()==std::char_traits<char>::eof()) {
+				is->clear();
+				return false;
+			}
+			XMLTagInfo info;
+			ReadTag(*is,info);
+			if (info.name=="recordindex") return false;
+			if (info.name!="record" || !info.isstart || info.isend)
+				throw streamexception("Stream Input Format Error: expected start tag for record, received tag for "+info.name);
+			std::map<std::string,std::string>::iterator l
+				= info.attr.find("len");
+			if (l==info.attr.end())
+				throw streamexception("Stream Input Format Error: record missing len");
+			len = std::strtol(l->second.c_str(),0,10);
+			return true;
+		}
+
+		// finds the offsets, from the index at the end if there is one
+		// and otherwise from the records
+		void buildindex() {
+			if (indexed) return;
+			indexed = true;
+			std::streampos here = is->tellg();
+			is->clear();
+			is->seekg(0,std::ios_base::end);
+			std::streamoff size = std::streamoff(is->tellg())-base;
+			std::size_t flen = RecordFooter::length();
+			if (size>=std::streamoff(flen)) {
+				std::string footer(flen,' ');
+				is->seekg(base+size-std::streamoff(flen));
+				is->read(&footer[0],flen);
+				std::size_t plen = std::strlen(RecordFooter::prefix());
+				if (*is && !footer.compare(0,plen,RecordFooter::prefix())) {
+					is->seekg(base+std::streamoff(std::strtol(
+						footer.c_str()+plen,0,10)));
+					readindex(*is);
+					is->clear();
+					is->seekg(here);
+					return;
+				}
+			}
+			is->clear();
+			is->seekg(base);
+			offs.clear();
+			std::streamoff len;
+			while(1) {
+				IgnoreWS(*is);
+				std::streamoff at = std::streamoff(is->tellg())-base;
+				if (!readhead(len)) break;
+				offs.push_back(at);
+				is->seekg(len,std::ios_base::cur);
+				ReadEndTag(*is,"record");
+				end = std::streamoff(is->tellg())-base;
+			}
+			is->clear();
+			is->seekg(here);
+		}
+
+		std::istream *is;
+		std::streamoff base;
+		std::size_t n;
+		bool indexed;
+		std::vector<std::streamoff> offs;
+		std::streamoff end;
+	};
+
+}
+
+#endif // of file guard
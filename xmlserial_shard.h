@@ -0,0 +1,304 @@
+/* By Christian R. Shelton
+ * (christian.r.shelton@gmail.com)
+ * August 2014
+ *   [original release]
+ *
+ * Released under MIT software licence:
+ * The MIT License (MIT)
+ * Copyright (c) 2014 Christian R. Shelton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef XMLSERIAL_SHARD_H
+#define XMLSERIAL_SHARD_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <iterator>
+#include "xmlserial.h"
+#include "xmlserial_archive.h"
+#if __cplusplus > 199711L
+#include <mutex>
+#include <thread>
+#include <exception>
+#endif
+
+// Sharded archives:  a container (vector, deque or list) too large for
+// one stream is split into nshards streams, each holding a run of its
+// elements,
+//
+//    <shard index="1" nshards="4" nelem="250000">
+//    ...elements...
+//    <\shard>
+//
+// Each shard is written through its own archive, made a shard with
+// shardset::add, and these can be written (and read) at the same time.  Pointer ids are numbered within
+// each shard, and an object pointed to from several shards is written
+// only in the first shard to reach it; the others refer to it with an
+// xshard attribute, as in
+//
+//    <Node name="next" ptrid="17" xshard="2" \>
+//
+// (object 17 of shard 2).  On loading, such pointers are left null until
+// all shards are read and shardset::stitch() is called.
+//
+// SaveShards and LoadShards do all of this (in parallel, with C++11).
+
+namespace XMLSERIALNAMESPACE {
+
+	// the pointers shared by the shards of one save (or load)
+	class shardset : public ptrregistry {
+	public:
+		shardset(int nshards) : archives(nshards,(const archive *)0) {}
+
+		int size() const { return archives.size(); }
+
+		// makes a shard number shard
+		void add(archive &a, int shard) {
+			a.setshard(this,shard);
+			archives[shard] = &a;
+		}
+
+		// sets the pointers that refer to other shards, once all are
+		// loaded (the archives, and what they loaded, must be unchanged
+		// until then)
+		void stitch() {
+			for(std::size_t i=0;i<fixups.size();i++) {
+				const fixup &f = fixups[i];
+				if (f.shard<0 || f.shard>=size() || !archives[f.shard])
+					throw streamexception("Stream Input Format Error: no shard "+T2str(f.shard)+" for pointer of type "+f.name);
+				const archive &a = *archives[f.shard];
+				if (!a.validid(f.id) || !f.set(f.ptr,a,f.id))
+					throw streamexception("Stream Input Format Error: no object "+T2str(f.id)+" in shard "+T2str(f.shard)+" for pointer of type "+f.name);
+			}
+			fixups.clear();
+		}
+
+		virtual std::pair<int,int> claim(void *p, int shard, int id) {
+			lock();
+			std::pair<int,int> o = owners.insert(std::make_pair(p,
+				std::make_pair(shard,id))).first->second;
+			unlock();
+			return o;
+		}
+
+		virtual void defer(void *ptr,
+				bool (*set)(void *, const archive &, int),
+				int shard, int id, const char *name) {
+			fixup f;
+			f.ptr = ptr;
+			f.set = set;
+			f.shard = shard;
+			f.id = id;
+			f.name = name;
+			lock();
+			fixups.push_back(f);
+			unlock();
+		}
+
+	private:
+		void lock() {
+#if __cplusplus > 199711L
+			m.lock();
+#endif
+		}
+		void unlock() {
+#if __cplusplus > 199711L
+			m.unlock();
+#endif
+		}
+
+		// a pointer to be set to object id of shard
+		struct fixup {
+			void *ptr;
+			bool (*set)(void *, const archive &, int);
+			int shard, id;
+			const char *name;
+		};
+
+		std::vector<const archive *> archives;
+		// (saving) object address -> the shard that saves it, and its id
+		std::map<void *,std::pair<int,int> > owners;
+		// (loading)
+		std::vector<fixup> fixups;
+#if __cplusplus > 199711L
+		std::mutex m;
+#endif
+	};
+
+	// saves shard a.shardno() (of nshards) of c:  its share of the
+	// elements
+	template<typename C>
+	void SaveShard(const C &c, archive &a, int nshards) {
+		std::size_t n = c.size(), k = nshards, i = a.shardno();
+		std::size_t b = n*i/k, e = n*(i+1)/k;
+		typename C::const_iterator it = c.begin();
+		std::advance(it,b);
+		XMLTagInfo fields;
+		fields.name = "shard";
+		fields.isstart = true;
+		fields.isend = false;
+		fields.attr["index"] = T2str(i);
+		fields.attr["nshards"] = T2str(k);
+		fields.attr["nelem"] = T2str(e-b);
+		fields.write(a,0);
+		for(;b<e;++b,++it) Save(*it,a);
+		fields.isstart = false;
+		fields.isend = true;
+		fields.write(a,0);
+	}
+
+	// loads shard a.shardno() (of nshards), appending its elements to
+	// part (whose elements must not move until shardset::stitch() is
+	// called)
+	template<typename C>
+	void LoadShard(C &part, archive &a, int nshards) {
+		XMLTagInfo info;
+		ReadTag(a,info);
+		if (info.name!="shard" || !info.isstart)
+			throw streamexception("Stream Input Format Error: expected start tag for shard, received tag for "+info.name);
+		if (atoi(info.attr["index"].c_str())!=a.shardno()
+				|| atoi(info.attr["nshards"].c_str())!=nshards)
+			throw streamexception("Stream Input Format Error: expected shard "+T2str(a.shardno())+" of "+T2str(nshards)+", received shard "+info.attr["index"]+" of "+info.attr["nshards"]);
+		std::size_t n = strtoul(info.attr["nelem"].c_str(),0,10);
+		if (info.isend) return;
+		std::size_t b = part.size();
+		part.resize(b+n);
+		typename C::iterator it = part.begin();
+		std::advance(it,b);
+		for(std::size_t i=0;i<n;i++,++it) Load(*it,a);
+		ReadEndTag(a,"shard");
+	}
+
+	// saves c split across the (outs.size()) streams outs
+	template<typename C>
+	void SaveShards(const C &c, const std::vector<std::ostream *> &outs) {
+		shardset set(outs.size());
+#if __cplusplus > 199711L
+		std::vector<std::thread> threads;
+		std::vector<std::exception_ptr> errs(outs.size());
+		for(std::size_t i=0;i<outs.size();i++)
+			threads.push_back(std::thread([&,i]() {
+				try {
+					archive a(*outs[i]);
+					set.add(a,i);
+					SaveShard(c,a,set.size());
+				} catch(...) { errs[i] = std::current_exception(); }
+			}));
+		for(std::size_t i=0;i<threads.size();i++) threads[i].join();
+		for(std::size_t i=0;i<errs.size();i++)
+			if (errs[i]) std::rethrow_exception(errs[i]);
+#else
+		for(std::size_t i=0;i<outs.size();i++) {
+			archive a(*outs[i]);
+			set.add(a,i);
+			SaveShard(c,a,set.size());
+		}
+#endif
+	}
+
+	// appends to c the elements in the (ins.size()) streams ins, written
+	// by SaveShards, with the pointers between shards stitched
+	template<typename C>
+	void LoadShards(C &c, const std::vector<std::istream *> &ins) {
+		shardset set(ins.size());
+		std::vector<C> parts(ins.size());
+		std::vector<archive *> as(ins.size(),(archive *)0);
+		try {
+			for(std::size_t i=0;i<ins.size();i++) {
+				as[i] = new archive(*ins[i]);
+				set.add(*as[i],i);
+			}
+#if __cplusplus > 199711L
+			std::vector<std::thread> threads;
+			std::vector<std::exception_ptr> errs(ins.size());
+			for(std::size_t i=0;i<ins.size();i++)
+				threads.push_back(std::thread([&,i]() {
+					try {
+						LoadShard(parts[i],*as[i],set.size());
+					} catch(...) { errs[i] = std::current_exception(); }
+				}));
+			for(std::size_t i=0;i<threads.size();i++) threads[i].join();
+			for(std::size_t i=0;i<errs.size();i++)
+				if (errs[i]) std::rethrow_exception(errs[i]);
+#else
+			for(std::size_t i=0;i<ins.size();i++)
+				LoadShard(parts[i],*as[i],set.size());
+#endif
+			set.stitch();
+		} catch(...) {
+			for(std::size_t i=0;i<as.size();i++) delete as[i];
+			throw;
+		}
+		for(std::size_t i=0;i<as.size();i++) delete as[i];
+		for(std::size_t i=0;i<parts.size();i++)
+#if __cplusplus > 199711L
+			c.insert(c.end(),std::make_move_iterator(parts[i].begin()),
+				std::make_move_iterator(parts[i].end()));
+#else
+			c.insert(c.end(),parts[i].begin(),parts[i].end());
+#endif
+	}
+
+	// as above, with the shards in the named files
+	template<typename C>
+	void SaveShards(const C &c, const std::vector<std::string> &files) {
+		std::vector<std::ofstream *> fs;
+		std::vector<std::ostream *> outs;
+		try {
+			for(std::size_t i=0;i<files.size();i++) {
+				fs.push_back(new std::ofstream(files[i].c_str()));
+				if (!*fs.back())
+					throw streamexception("Stream Output Error: cannot open "+files[i]);
+				outs.push_back(fs.back());
+			}
+			SaveShards(c,outs);
+		} catch(...) {
+			for(std::size_t i=0;i<fs.size();i++) delete fs[i];
+			throw;
+		}
+		for(std::size_t i=0;i<fs.size();i++) delete fs[i];
+	}
+
+	template<typename C>
+	void LoadShards(C &c, const std::vector<std::string> &files) {
+		std::vector<std::ifstream *> fs;
+		std::vector<std::istream *> ins;
+		try {
+			for(std::size_t i=0;i<files.size();i++) {
+				fs.push_back(new std::ifstream(files[i].c_str()));
+				if (!*fs.back())
+					throw streamexception("Stream Input Error: cannot open "+files[i]);
+				ins.push_back(fs.back());
+			}
+			LoadShards(c,ins);
+		} catch(...) {
+			for(std::size_t i=0;i<fs.size();i++) delete fs[i];
+			throw;
+		}
+		for(std::size_t i=0;i<fs.size();i++) delete fs[i];
+	}
+
+}
+
+#endif // of file guard
@@ -0,0 +1,136 @@
+/* By Christian R. Shelton
+ * (christian.r.shelton@gmail.com)
+ * August 2014
+ *   [original release]
+ *
+ * Released under MIT software licence:
+ * The MIT License (MIT)
+ * Copyright (c) 2014 Christian R. Shelton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef XMLSERIAL_SKIP_H
+#define XMLSERIAL_SKIP_H
+
+#include <string>
+#include <cstring>
+#include "xmlserial.h"
+
+// Skipping elements without parsing them.
+//
+// Having read an element's start tag, SkipElement reads the rest of the
+// element (through its matching end tag) looking only at the tags' < and >
+// and the \ that marks end tags and self-closing tags:  no XMLTagInfo is
+// filled in, nothing is unescaped, and no memory is allocated per element.
+// Only the final end tag is checked against the start tag.
+//
+// This relies on text between tags, and attribute values, never holding
+// a raw < or > (they are always written as &lt; and &gt;).  Types written
+// with a user's operator<< (USESHIFT) must keep to this too.
+
+namespace XMLSERIALNAMESPACE {
+
+	// [b,e) is the text just after the start tag of an element called
+	// name.  Returns the end of its matching end tag, and sets bodyend to
+	// the start of that end tag.
+	inline const char *SkipElement(const char *b, const char *e,
+			const std::string &name, const char *&bodyend) {
+		std::size_t depth = 1;
+		const char *p = b;
+		while(1) {
+			const char *lt = (const char *)memchr(p,'<',e-p);
+			if (!lt) break;
+			const char *gt = (const char *)memchr(lt,'>',e-lt);
+			if (!gt) break;
+			if (lt+1<gt && lt[1]=='\\') {
+				if (--depth==0) {
+					if (std::size_t(gt-lt-2)!=name.length()
+							|| memcmp(lt+2,name.data(),name.length()))
+						throw streamexception(std::string("Stream Input Format Error: expected end tag for ")+name+", received end tag for "+std::string(lt+2,gt));
+					bodyend = lt;
+					return gt+1;
+				}
+			} else if (gt[-1]!='\\') depth++;
+			p = gt+1;
+		}
+		throw streamexception("Stream Input Format Error: unexpected stream end");
+	}
+
+	// reads is (a block at a time) up to, but not including, delim,
+	// appending what it read to text (if not null).  Returns false at the
+	// end of the stream.
+	template<typename S>
+	bool SkipTo(S &is, char delim, std::string *text) {
+		enum { BLOCK = 1<<13 };
+		char buf[BLOCK+1];
+		while(1) {
+			is.get(buf,BLOCK+1,delim);
+			std::streamsize got = is.gcount();
+			if (text) text->append(buf,got);
+			if (is.rdstate() & (std::ios_base::eofbit|std::ios_base::badbit))
+				return false;
+			// get fails if delim is immediately next
+			if (got==0) is.clear(is.rdstate() & ~std::ios_base::failbit);
+			if (got<BLOCK) return true;
+		}
+	}
+
+	// a check on the tags SkipElement passes over that accepts them all
+	struct anytag {
+		void operator()(const std::string &) const { }
+	};
+
+	// info is the start tag just read from is; reads the rest of its
+	// element, passing each start tag in it (as text) to check.  If text
+	// is not null, the element's contents (everything between its start
+	// and end tags) are appended to it.
+	template<typename S, typename C>
+	void SkipElement(S &is, const XMLTagInfo &info, std::string *text,
+			const C &check) {
+		if (info.isend) return;
+		std::string tag; // the last tag read
+		std::size_t depth = 1;
+		while(1) {
+			if (!SkipTo(is,'<',text)) break;
+			tag.assign(1,char(is.get()));
+			if (!SkipTo(is,'>',&tag)) break;
+			tag.push_back(char(is.get()));
+			if (tag[1]=='\\') {
+				if (--depth==0) {
+					if (tag.compare(2,tag.length()-3,info.name))
+						throw streamexception(std::string("Stream Input Format Error: expected end tag for ")+info.name+", received end tag for "+tag.substr(2,tag.length()-3));
+					return;
+				}
+			} else {
+				check(tag);
+				if (tag[tag.length()-2]!='\\') depth++;
+			}
+			if (text) text->append(tag);
+		}
+		throw streamexception("Stream Input Format Error: unexpected stream end");
+	}
+
+	template<typename S>
+	void SkipElement(S &is, const XMLTagInfo &info, std::string *text=0) {
+		SkipElement(is,info,text,anytag());
+	}
+}
+
+#endif // of file guard
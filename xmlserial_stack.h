@@ -44,7 +44,7 @@ namespace XMLSERIALNAMESPACE {
 		inline static bool isinline(const std::stack<T,C> &) { return false; }
 		template<typename S>
 		inline static void save(const std::stack<T,C> s, S &os,int indent) {
-			os << std::endl;
+			os << '\n';
 			XMLTagInfo fields;
 			SaveWrapper(getcontainer<std::stack<T,C> >::get(s),fields,os,indent+1);
 			Indent(os,indent);
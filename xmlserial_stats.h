@@ -0,0 +1,156 @@
+/* By Christian R. Shelton
+ * (christian.r.shelton@gmail.com)
+ * August 2014
+ *   [original release]
+ *
+ * Released under MIT software licence:
+ * The MIT License (MIT)
+ * Copyright (c) 2014 Christian R. Shelton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef XMLSERIAL_STATS_H
+#define XMLSERIAL_STATS_H
+
+// Instrumentation:  compiled with XMLSERIAL_STATS defined (before any
+// xmlserial header), the library counts what it does in an
+// xmlserial::Stats for each thread.  GetStats() returns a copy, so the
+// difference of two copies gives the counts for the calls between them.
+// Without XMLSERIAL_STATS, nothing is counted (and GetStats() is all 0s).
+//
+// Bytes read and written are counted by the top-level Save and Load
+// calls (and the classes' Save and Load methods) from the stream's
+// position, so streams that cannot tell their position (tellp or tellg
+// returning -1) add nothing.  Note that the counters themselves are not
+// free:  keep XMLSERIAL_STATS off in builds that are not being measured.
+
+#ifdef XMLSERIAL_STATS
+#define XMLSERIAL_COUNT(counter,n) \
+	(XMLSERIALNAMESPACE::StatsNow().counter += (n))
+#else
+#define XMLSERIAL_COUNT(counter,n)
+#endif
+
+namespace XMLSERIALNAMESPACE {
+
+	struct Stats {
+		typedef unsigned long long count;
+
+		count bytes_read, bytes_written;
+		count tags_read, attrs_read, tags_written;
+		count taginfos; // XMLTagInfos made
+		count stringstreams; // string streams made to convert values
+		count strings_read; // strings (and borrowed strings) loaded
+		count ptrcache_hits, ptrcache_misses; // archive pointer cache
+		count factory_lookups; // polymorphic classes allocated by name
+
+		Stats() : bytes_read(0), bytes_written(0), tags_read(0),
+			attrs_read(0), tags_written(0), taginfos(0),
+			stringstreams(0), strings_read(0), ptrcache_hits(0),
+			ptrcache_misses(0), factory_lookups(0) {}
+
+		// calls f(name,value) for each counter (for exporting)
+		template<typename F>
+		void foreach(F &f) const {
+			f("bytes_read",bytes_read);
+			f("bytes_written",bytes_written);
+			f("tags_read",tags_read);
+			f("attrs_read",attrs_read);
+			f("tags_written",tags_written);
+			f("taginfos",taginfos);
+			f("stringstreams",stringstreams);
+			f("strings_read",strings_read);
+			f("ptrcache_hits",ptrcache_hits);
+			f("ptrcache_misses",ptrcache_misses);
+			f("factory_lookups",factory_lookups);
+		}
+
+		Stats operator-(const Stats &s) const {
+			Stats ret;
+			ret.bytes_read = bytes_read-s.bytes_read;
+			ret.bytes_written = bytes_written-s.bytes_written;
+			ret.tags_read = tags_read-s.tags_read;
+			ret.attrs_read = attrs_read-s.attrs_read;
+			ret.tags_written = tags_written-s.tags_written;
+			ret.taginfos = taginfos-s.taginfos;
+			ret.stringstreams = stringstreams-s.stringstreams;
+			ret.strings_read = strings_read-s.strings_read;
+			ret.ptrcache_hits = ptrcache_hits-s.ptrcache_hits;
+			ret.ptrcache_misses = ptrcache_misses-s.ptrcache_misses;
+			ret.factory_lookups = factory_lookups-s.factory_lookups;
+			return ret;
+		}
+	};
+
+	// this thread's counters
+	inline Stats &StatsNow() {
+#if __cplusplus > 199711L
+		static thread_local Stats s;
+#else
+		static Stats s;
+#endif
+		return s;
+	}
+
+	inline Stats GetStats() { return StatsNow(); }
+	inline void ResetStats() { StatsNow() = Stats(); }
+
+	// counts the bytes a top-level Save or Load moves the stream by
+	template<typename S>
+	struct StatsWrite {
+#ifdef XMLSERIAL_STATS
+		StatsWrite(S &s) : os(s), start(pos()) {}
+		~StatsWrite() {
+			std::streamoff end = pos();
+			if (start>=0 && end>=start)
+				StatsNow().bytes_written += end-start;
+		}
+		// (not asking a stream that is not good, as that would set fail)
+		std::streamoff pos() {
+			return os.good() ? std::streamoff(os.tellp()) : std::streamoff(-1);
+		}
+		S &os;
+		std::streamoff start;
+#else
+		StatsWrite(S &) {}
+#endif
+	};
+
+	template<typename S>
+	struct StatsRead {
+#ifdef XMLSERIAL_STATS
+		StatsRead(S &s) : is(s), start(pos()) {}
+		~StatsRead() {
+			std::streamoff end = pos();
+			if (start>=0 && end>=start)
+				StatsNow().bytes_read += end-start;
+		}
+		std::streamoff pos() {
+			return is.good() ? std::streamoff(is.tellg()) : std::streamoff(-1);
+		}
+		S &is;
+		std::streamoff start;
+#else
+		StatsRead(S &) {}
+#endif
+	};
+}
+
+#endif // of file guard
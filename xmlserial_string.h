@@ -30,35 +30,138 @@
 #define XMLSERIAL_STRING_H
 
 #include "xmlserial.h"
+#include "xmlserial_bulk.h"
 
 namespace XMLSERIALNAMESPACE {
+	// the string table of an archive (see archive::strtable), when loading
+	template<typename S,typename Condition=void>
+	struct StrTable {
+		inline static void add(S &, int, const std::string &) { }
+		inline static void lookup(S &, int, std::string &) {
+			throw streamexception("Stream Input Format Error: string reference (sref) needs an archive");
+		}
+	};
+
+	template<typename S>
+	struct StrTable<S,typename Type_If<ArchiveInfo<S>::hasstrtable,void>::type> {
+		inline static void add(S &is, int id, const std::string &s) {
+			if (!is.addstr(id,s))
+				throw streamexception(std::string("Stream Input Format Error: string id (sid) ")+T2str(id)+" out of order");
+		}
+		inline static void lookup(S &is, int id, std::string &s) {
+			if (!is.lookupstr(id,s))
+				throw streamexception(std::string("Stream Input Format Error: string reference (sref) ")+T2str(id)+" to an unknown string");
+		}
+	};
+
 	template<>
 	struct TypeInfo<std::string,void> {
+		// the most len reserves ahead of reading the text (len comes
+		// from the input, so it is only a hint)
+		enum { MAXRESERVE = 1<<24 };
+
 		inline static const char *namestr() { return "string"; }
+		// long strings are written as (base64) blobs if blobstrings is set
 		template<typename S>
-		inline static void addotherattr(XMLTagInfo &,const std::string &,
-				S &) { }
-		inline static bool isshort(const std::string &s) { return s.length()<20; }
+		inline static bool isblob(const std::string &s, S &os) {
+			return !isshort(s) && HasEnc(os,ENC_BLOBSTRINGS);
+		}
+		template<typename S>
+		inline static void addotherattr(XMLTagInfo &fields,
+				const std::string &s, S &os) {
+			// (len lets the loader size the string before reading it)
+			if (!isshort(s)) fields.attr["len"] = T2str(s.length());
+			if (isblob(s,os)) fields.attr["enc"] = "b64";
+		}
+		// (a NUL would end the value attribute, but not the text)
+		inline static bool isshort(const std::string &s) {
+			return s.length()<20 && s.find('\0')==std::string::npos;
+		}
 		inline static bool isinline(const std::string &s) { return false; }
 		template<typename S>
 		inline static void save(const std::string &s, S &os,
 				int indent) {
-			WriteStr(os,s,isshort(s));
+			if (isblob(s,os)) BulkIO<char>::save(s.data(),s.length(),os);
+			else WriteStr(os,s,isshort(s));
 		}
 		template<typename S>
 		inline static void load(std::string &s, const XMLTagInfo &info,
 				S &is) {
+			XMLSERIAL_COUNT(strings_read,1);
+			std::map<std::string,std::string>::const_iterator ri
+				=info.attr.find("sref");
+			if (ri!=info.attr.end()) {
+				StrTable<S>::lookup(is,atoi(ri->second.c_str()),s);
+				if (!info.isend) ReadEndTag(is,namestr());
+				return;
+			}
+			loadvalue(s,info,is);
+			std::map<std::string,std::string>::const_iterator ii
+				=info.attr.find("sid");
+			if (ii!=info.attr.end())
+				StrTable<S>::add(is,atoi(ii->second.c_str()),s);
+		}
+		template<typename S>
+		inline static void loadvalue(std::string &s, const XMLTagInfo &info,
+				S &is) {
+			std::map<std::string,std::string>::const_iterator li
+				=info.attr.find("len");
+			if (IsB64(info)) {
+				if (li==info.attr.end())
+					throw streamexception("Stream Input Format Error: string blob needs len attribute");
+				std::size_t n = strtoul(li->second.c_str(),0,10);
+				if (n>s.max_size())
+					throw streamexception("Stream Input Format Error: string blob len "+li->second+" too large");
+				// the string grows a block (a multiple of 3 bytes) at a
+				// time as the data is read, so a wrong len cannot make
+				// it larger than the data
+				const std::size_t block = 64*BulkIO<char>::BLOCK;
+				s.clear();
+				for(std::size_t pos=0;pos<n;) {
+					std::size_t k = n-pos<block ? n-pos : block;
+					s.resize(pos+k);
+					BulkIO<char>::load(&s[pos],k,is);
+					pos += k;
+				}
+				ReadEndTag(is,namestr());
+				return;
+			}
 			std::map<std::string,std::string>::const_iterator vi
 				=info.attr.find("value");
 			if (vi!=info.attr.end()) {
 				std::istringstream ss(vi->second);
+				XMLSERIAL_COUNT(stringstreams,1);
 				dupfmt(ss,is);
 				ReadStr(ss,s,"");
 				if (info.isend) return;
-			} else ReadStr(is,s,"<");
+			} else {
+				s.clear();
+				if (li!=info.attr.end()) {
+					std::size_t n = strtoul(li->second.c_str(),0,10);
+					s.reserve(n<MAXRESERVE ? n : std::size_t(MAXRESERVE));
+				}
+				ReadText(is,s);
+			}
 			ReadEndTag(is,namestr());
 		}
 	};
 
+	// with an archive's string table, a string already written is
+	// written again as just a reference to the first
+	inline void SaveWrapper(const std::string &v, XMLTagInfo &fields,
+			archive &os, int indent) {
+		int id;
+		if (os.findoraddstr(v,id)) {
+			fields.attr["sref"] = T2str(id);
+			fields.isstart = true;
+			fields.isend = true;
+			fields.name = TypeInfo<std::string>::namestr();
+			fields.write(os,indent);
+			return;
+		}
+		if (id>=0) fields.attr["sid"] = T2str(id);
+		SaveWrapper<std::string,archive>(v,fields,os,indent);
+	}
+
 }
 #endif
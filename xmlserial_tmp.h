@@ -84,6 +84,12 @@ namespace XMLSERIALNAMESPACE {
 			(& chkdef(...))[2];
 		XMLSERIAL_DECVAL(HasDefault,sizeof(chkdef<T>(0)) == 1)
 
+		template<typename S> static char
+			(& chkmid(type_check<int (*)(),&S::xmlserial_mid>*))[1];
+		template<typename> static char
+			(& chkmid(...))[2];
+		XMLSERIAL_DECVAL(HasMemberId,sizeof(chkmid<T>(0)) == 1)
+
 		template<typename S> static char
 			(& chkv(type_check<T *(*)(std::istream &),
 				   &S::LoadV>*))[1];
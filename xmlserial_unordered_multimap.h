@@ -44,10 +44,11 @@ namespace XMLSERIALNAMESPACE {
 		template<typename S>
 		inline static void save(const std::unordered_multimap<K,T,C,A> m,
 				S &os,int indent) {
-			os << std::endl;
+			os << '\n';
 			int c=0;
 			for(typename std::unordered_multimap<K,T,C,A>::const_iterator i=m.begin();
 					i!=m.end();++i,++c) {
+				XMLSERIAL_OBSERVE_SAVE(S,namestr(),"",os);
 				XMLTagInfo fields;
 				SaveWrapper(*i,fields,os,indent+1,"key","value");
 			}
@@ -58,13 +59,13 @@ namespace XMLSERIALNAMESPACE {
 				S &is) {
 			m.clear();
 			XMLTagInfo eleminfo;
-			int i=0;
 			while(1) {
 				ReadTag(is,eleminfo);
 				if (eleminfo.isend && !eleminfo.isstart) {
 					if (eleminfo.name == namestr()) return;
 					throw streamexception(std::string("Stream Input Format Error: expected end tag for ")+namestr()+", received end tag for "+eleminfo.name);
 				}
+				XMLSERIAL_OBSERVE_LOAD(S,namestr(),"",is);
 				std::pair<K,T> elem;
 				TypeInfo<std::pair<K,T> >::load(elem,eleminfo,is,"key","value");
 #if __cplusplus > 199711L
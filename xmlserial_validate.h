@@ -0,0 +1,514 @@
+/* By Christian R. Shelton
+ * (christian.r.shelton@gmail.com)
+ * August 2014
+ *   [original release]
+ *
+ * Released under MIT software licence:
+ * The MIT License (MIT)
+ * Copyright (c) 2014 Christian R. Shelton
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef XMLSERIAL_VALIDATE_H
+#define XMLSERIAL_VALIDATE_H
+
+#include <string>
+#include <vector>
+#include <limits>
+#include <streambuf>
+#include <cstdlib>
+#include "xmlserial.h"
+#include "xmlserial_bulk.h"
+
+// Validation:  Validate<T>(is) reads what Load would read into a T and
+// throws the streamexception Load would (roughly) throw, but makes no T.
+// It checks
+//
+//    - that tags are well formed and nested, and end tags match
+//    - the tag of each value against its type (as CheckTag does)
+//    - that each member of a class is one it has (by name or by id), and
+//      that all members without defaults are present (as AllLoaded does)
+//    - the syntax of numbers (in value attributes, and in the text of
+//      containers of numbers), as >> reads them:  decimal only, and 0 or
+//      1 for bools
+//
+// Tags (and numbers in text, one at a time) are read into buffers that
+// are kept from tag to tag, so nothing is allocated for each element
+// (once the buffers are large enough).
+//
+// Some things are only checked for balance:  objects pointed to whose
+// type is a subclass of the pointer's type, pointer ids, base64 contents,
+// the text of strings, and types written with operator<< (USESHIFT).
+
+namespace XMLSERIALNAMESPACE {
+
+	// reads tags (and text) straight from a streambuf
+	class validreader {
+	public:
+		validreader(std::streambuf *b) : sb(b), nattr(0), nopen(0) {}
+
+		// the last tag read
+		bool isstart, isend;
+		std::string name;
+		// the value (not unescaped) of its attribute a (0 if none)
+		const std::string *attr(const char *a) const {
+			for(std::size_t i=0;i<nattr;i++)
+				if (attrs[i].first==a) return &attrs[i].second;
+			return 0;
+		}
+
+		// reads the next tag (with only white space before it)
+		void readtag() {
+			int c = skipws();
+			if (c!='<') error("expected <");
+			readtagbody();
+		}
+
+		// reads the next tag, which must be the end tag for ename
+		void readend(const char *ename) {
+			readtag();
+			if (!isend || isstart || name!=ename)
+				error(std::string("expected end tag for ")+ename+", received "+(isstart ? "start" : "end")+" tag for "+name);
+		}
+
+		// reads the next word of text (up to white space or the next tag)
+		// into w, returning false if there is none before the next tag
+		bool readword(std::string &w) {
+			w.clear();
+			int c;
+			while(isws(c=peek())) sb->sbumpc();
+			for(;c!='<' && !isws(c);c=peek()) {
+				if (c==eof()) error("unexpected stream end");
+				w.push_back(char(sb->sbumpc()));
+			}
+			return !w.empty();
+		}
+
+		// reads the text up to the next tag
+		void skiptext() {
+			for(int c=peek();c!='<';c=peek()) {
+				if (c==eof()) error("unexpected stream end");
+				sb->sbumpc();
+			}
+		}
+
+		// reads the rest of the element whose start tag was just read
+		void skip() {
+			if (isend) return;
+			std::size_t base = nopen;
+			push(name);
+			while(nopen>base) {
+				int c;
+				while((c=sb->sbumpc())!='<')
+					if (c==eof()) error("unexpected stream end");
+				readtagbody();
+				if (isstart) {
+					if (!isend) push(name);
+				} else if (name!=open[--nopen])
+					error(std::string("expected end tag for ")+open[nopen]+", received end tag for "+name);
+			}
+		}
+
+		void error(const std::string &what) const {
+			throw streamexception("Stream Input Format Error: "+what);
+		}
+
+	private:
+		static int eof() { return std::char_traits<char>::eof(); }
+		int peek() { return sb->sgetc(); }
+		static bool isws(int c) {
+			return c==' ' || c=='\t' || c=='\n' || c=='\r' || c=='\v'
+				|| c=='\f';
+		}
+		int skipws() {
+			int c;
+			while(isws(c=sb->sbumpc())) ;
+			return c;
+		}
+		int getnotend() {
+			int c = sb->sbumpc();
+			if (c==eof()) error("unexpected stream end");
+			return c;
+		}
+
+		// (after the <)
+		void readtagbody() {
+			nattr = 0;
+			name.clear();
+			int c = getnotend();
+			isstart = c!='\\';
+			isend = !isstart;
+			if (!isstart) c = getnotend();
+			while(!isws(c) && c!='>' && c!='\\' && c!='=') {
+				name.push_back(char(c));
+				c = getnotend();
+			}
+			if (name.empty()) error("tag missing name");
+			while(1) {
+				while(isws(c)) c = getnotend();
+				if (c=='>') return;
+				if (c=='\\' && isstart) {
+					isend = true;
+					if (getnotend()!='>') error("expected >");
+					return;
+				}
+				if (!isstart) error("expected >");
+				if (nattr==attrs.size())
+					attrs.push_back(std::pair<std::string,std::string>());
+				std::pair<std::string,std::string> &a = attrs[nattr++];
+				a.first.clear();
+				a.second.clear();
+				while(!isws(c) && c!='>' && c!='\\' && c!='=') {
+					if (c=='"') error("tag missing name");
+					a.first.push_back(char(c));
+					c = getnotend();
+				}
+				if (a.first.empty()) error("tag missing name");
+				while(isws(c)) c = getnotend();
+				if (c!='=') {
+					a.second = "1";
+					continue;
+				}
+				c = getnotend();
+				while(isws(c)) c = getnotend();
+				if (c=='"') {
+					while((c=getnotend())!='"') a.second.push_back(char(c));
+					c = getnotend();
+				} else {
+					while(!isws(c) && c!='>' && c!='\\') {
+						a.second.push_back(char(c));
+						c = getnotend();
+					}
+				}
+			}
+		}
+
+		void push(const std::string &n) {
+			if (nopen==open.size()) open.push_back(n);
+			else open[nopen] = n;
+			nopen++;
+		}
+
+		std::streambuf *sb;
+		std::vector<std::pair<std::string,std::string> > attrs;
+		std::size_t nattr;
+		std::vector<std::string> open; // (for skip)
+		std::size_t nopen;
+	};
+
+	// how numbers of type T are written (characters are written as
+	// themselves, so any text will do)
+	enum numkind { NUM_ANY, NUM_SIGNED, NUM_UNSIGNED, NUM_BOOL, NUM_FLOAT };
+
+	template<typename T>
+	struct NumKind {
+		static const numkind value = !std::numeric_limits<T>::is_integer ? NUM_FLOAT
+			: sizeof(T)==1 ? NUM_ANY
+			: std::numeric_limits<T>::is_signed ? NUM_SIGNED
+			: NUM_UNSIGNED;
+	};
+	template<>
+	struct NumKind<bool> {
+		static const numkind value = NUM_BOOL;
+	};
+
+	// the syntax of numbers of type T
+	template<typename T>
+	struct NumSyntax {
+		static const numkind kind = NumKind<T>::value;
+
+		// is [p,e) a number?
+		static bool valid(const char *p, const char *e) {
+			if (kind==NUM_ANY) return p<e;
+			if (kind==NUM_FLOAT) return IsDecimalNum(p,e);
+			bool neg = p<e && *p=='-';
+			if (p<e && (*p=='+' || (neg && kind!=NUM_UNSIGNED))) ++p;
+			const char *b = p;
+			while(p<e && *p>='0' && *p<='9') ++p;
+			if (p==b || p!=e) return false;
+			if (kind!=NUM_BOOL) return true;
+			// (without boolalpha, >> reads a bool as a number, 0 or 1)
+			while(b<e-1 && *b=='0') ++b;
+			return *b=='0' || (*b=='1' && !neg);
+		}
+
+		static void check(const std::string &s, validreader &r) {
+			if (!valid(s.data(),s.data()+s.length()))
+				r.error("\""+s+"\" is not a "+TypeInfo<T>::namestr()+" (for "+r.name+")");
+		}
+
+		// checks the numbers separated by white space up to the next tag,
+		// reading them one at a time into word, and returns how many
+		static std::size_t checkall(validreader &r, std::string &word) {
+			std::size_t n = 0;
+			while(r.readword(word)) {
+				if (!valid(word.data(),word.data()+word.length()))
+					r.error("\""+word+"\" is not a "+TypeInfo<T>::namestr()+" (in "+r.name+")");
+				n++;
+			}
+			return n;
+		}
+	};
+
+	template<typename T>
+	struct IsBasicString {
+		enum { value = false };
+	};
+	template<typename C, typename Tr, typename A>
+	struct IsBasicString<std::basic_string<C,Tr,A> > {
+		enum { value = true };
+	};
+
+	// the type of the elements of a container (as loaded)
+	template<typename T>
+	struct ElemType {
+		typedef T type;
+	};
+	template<typename K, typename V>
+	struct ElemType<std::pair<const K,V> > {
+		typedef std::pair<K,V> type;
+	};
+
+	// checks the tag just read is a start tag for a T
+	template<typename T>
+	inline void ValidateTag(validreader &r) {
+		if (!r.isstart)
+			r.error(std::string("expected start tag for ")+TypeInfo<T>::namestr()+", received end tag for "+r.name);
+		if (r.name != TypeInfo<T>::namestr())
+			r.error(std::string("expected start tag for ")+TypeInfo<T>::namestr()+", received start tag for "+r.name);
+	}
+
+	template<typename L>
+	struct ValidateItt;
+
+	// validates a T, whose start tag has just been read, through its end
+	// (otherwise:  only its tag is checked)
+	template<typename T,typename Condition=void>
+	struct ValidateType {
+		inline static void exec(validreader &r, std::string &) {
+			ValidateTag<T>(r);
+			r.skip();
+		}
+	};
+
+	// numbers
+	template<typename T>
+	struct ValidateType<T,typename Type_If<std::numeric_limits<T>::is_specialized
+			&& !PtrInfo<T>::isptr,void>::type> {
+		inline static void exec(validreader &r, std::string &text) {
+			ValidateTag<T>(r);
+			const std::string *v = r.attr("value");
+			if (v) {
+				NumSyntax<T>::check(*v,r);
+				if (!r.isend) r.readend(TypeInfo<T>::namestr());
+			} else {
+				if (r.isend) r.error(std::string("missing value for ")+r.name);
+				if (NumSyntax<T>::checkall(r,text)!=1)
+					r.error(std::string("expected one value for ")+r.name);
+				r.readend(TypeInfo<T>::namestr());
+			}
+		}
+	};
+
+	// classes
+	template<typename T>
+	struct ValidateType<T,typename Type_If<TypeProp<T>::HasIDname
+			&& !PtrInfo<T>::isptr,void>::type> {
+		typedef typename T::xmlserial_alllist L;
+
+		inline static void exec(validreader &r, std::string &text) {
+			ValidateTag<T>(r);
+			if (r.isend) body(r,text,true);
+			else body(r,text,false);
+		}
+
+		// the members (none if empty)
+		inline static void body(validreader &r, std::string &text,
+				bool empty) {
+			const char *cname = T::xmlserial_IDname();
+			char seen[ValidateItt<L>::n+1];
+			for(int i=0;i<ValidateItt<L>::n;i++) seen[i] = 0;
+			while(!empty) {
+				r.readtag();
+				if (r.isend && !r.isstart) {
+					if (r.name != cname)
+						r.error(std::string("expected end tag for ")+cname+", received end tag for "+r.name);
+					break;
+				}
+				if (!ValidateItt<L>::exec((T *)0,r,text,seen)) {
+					const std::string *n = r.attr("name");
+					if (!n) n = r.attr("mid");
+					throw streamexception(std::string("Extra field ")+(n ? *n : std::string())+" of type "+r.name+" in object "+cname);
+				}
+			}
+			if (!ValidateItt<L>::required((T *)0,seen))
+				throw streamexception(std::string("Stream Input Format Error: not all fields present for ")+cname);
+		}
+	};
+
+	// pointers:  null, a pointer already written, or the object
+	template<typename T>
+	struct ValidateType<T,typename Type_If<PtrInfo<T>::isptr,void>::type> {
+		typedef typename PtrInfo<T>::BaseType B;
+
+		inline static void exec(validreader &r, std::string &text) {
+			if (!r.isstart)
+				r.error(std::string("expected start tag, received end tag for ")+r.name);
+			const std::string *nv = r.attr("isnull");
+			if (nv && *nv=="1") {
+				if (!r.isend) r.readend(r.name.c_str());
+				return;
+			}
+			if (r.isend && r.attr("ptrid")) return;
+			if (r.name == TypeInfo<B>::namestr())
+				ValidateType<B>::exec(r,text);
+			else r.skip(); // (a subclass)
+		}
+	};
+
+	// strings
+	template<typename C, typename Tr, typename A>
+	struct ValidateType<std::basic_string<C,Tr,A>,void> {
+		inline static void exec(validreader &r, std::string &) {
+			ValidateTag<std::basic_string<C,Tr,A> >(r);
+			r.skip();
+		}
+	};
+
+	// pairs:  first and second (or key and value), as attributes if both
+	// are numbers, otherwise as elements
+	template<typename T1, typename T2>
+	struct ValidateType<std::pair<T1,T2>,void> {
+		typedef typename StripConst<T1>::type U1;
+		typedef typename StripConst<T2>::type U2;
+
+		inline static void exec(validreader &r, std::string &text) {
+			ValidateTag<std::pair<T1,T2> >(r);
+			if (IsShiftable<U1>::quickly && IsShiftable<U2>::quickly) {
+				const std::string *v1 = r.attr("first"), *v2 = r.attr("second");
+				if (!v1) v1 = r.attr("key");
+				if (!v2) v2 = r.attr("value");
+				if (!v1 || !v2) r.error(std::string("missing value for ")+r.name);
+				NumSyntax<U1>::check(*v1,r);
+				NumSyntax<U2>::check(*v2,r);
+				r.skip();
+				return;
+			}
+			if (r.isend) r.error(std::string("not all fields present for ")+r.name);
+			std::string pname = r.name;
+			r.readtag();
+			ValidateType<U1>::exec(r,text);
+			r.readtag();
+			ValidateType<U2>::exec(r,text);
+			r.readend(pname.c_str());
+		}
+	};
+
+	// containers:  elements, or text (numbers, say), or base64
+	template<typename T>
+	struct ValidateType<T,typename Type_If<IsRange<T>::value
+			&& !IsBasicString<T>::value && !TypeProp<T>::HasIDname
+			&& !PtrInfo<T>::isptr,void>::type> {
+		typedef typename ElemType<typename T::value_type>::type E;
+
+		inline static void exec(validreader &r, std::string &text) {
+			ValidateTag<T>(r);
+			if (r.isend) return;
+			const std::string *enc = r.attr("enc");
+			if (enc) {
+				r.skip();
+				return;
+			}
+			const std::string *ne = r.attr("nelem");
+			long nelem = ne ? strtol(ne->c_str(),0,10) : -1;
+			std::string cname = r.name;
+			if (IsShiftable<E>::atall) {
+				if (std::numeric_limits<E>::is_specialized) {
+					std::size_t n = NumSyntax<E>::checkall(r,text);
+					if (nelem>=0 && n!=std::size_t(nelem))
+						r.error(std::string("expected ")+T2str(nelem)+" elements in "+cname+", found "+T2str(n));
+				} else r.skiptext();
+				r.readend(cname.c_str());
+				return;
+			}
+			while(1) {
+				r.readtag();
+				if (r.isend && !r.isstart) {
+					if (r.name != cname)
+						r.error(std::string("expected end tag for ")+cname+", received end tag for "+r.name);
+					return;
+				}
+				ValidateType<E>::exec(r,text);
+			}
+		}
+	};
+
+	// finds the member of O for the tag just read (returning false if
+	// none) and validates it, marking it in seen
+	template<typename L>
+	struct ValidateItt {
+		enum { n = 0 };
+		template<typename O>
+		inline static bool exec(O, validreader &, std::string &, char *) {
+			return false;
+		}
+		template<typename O>
+		inline static bool required(O, const char *) { return true; }
+	};
+
+	template<typename H, typename T>
+	struct ValidateItt<List<H,T> > {
+		typedef typename H::valtype V;
+		enum { pos = ValidateItt<T>::n, n = pos+1 };
+
+		template<typename O>
+		inline static bool exec(O o, validreader &r, std::string &text,
+				char *seen) {
+			const std::string *a = r.attr("mid");
+			bool match = a ? strtol(a->c_str(),0,10)==MemberId<H,T>::id()
+				: (a = r.attr("name")) && *a==H::getname(o);
+			if (!match) return ValidateItt<T>::exec(o,r,text,seen);
+			ValidateType<V>::exec(r,text);
+			seen[pos] = 1;
+			return true;
+		}
+
+		template<typename O>
+		inline static bool required(O o, const char *seen) {
+			if (!seen[pos] && !TypeProp<H>::HasDefault
+					&& !IsEmpty<V>::value)
+				return false;
+			return ValidateItt<T>::required(o,seen);
+		}
+	};
+
+	// checks that is holds a T as Load would read it (throwing a
+	// streamexception if not), without making one
+	template<typename T, typename S>
+	void Validate(S &is) {
+		validreader r(is.rdbuf());
+		std::string text;
+		r.readtag();
+		ValidateType<T>::exec(r,text);
+	}
+
+}
+
+#endif // of file guard
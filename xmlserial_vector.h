@@ -32,6 +32,7 @@
 #include <vector>
 #include <sstream>
 #include "xmlserial.h"
+#include "xmlserial_bulk.h"
 
 namespace XMLSERIALNAMESPACE {
 	// if T is not "shiftable"
@@ -48,10 +49,11 @@ namespace XMLSERIALNAMESPACE {
 		template<typename S>
 		inline static void save(const std::vector<T,A> &v,
 				S &os,int indent) {
-			os << std::endl;
+			os << '\n';
 			int c=0;
 			for(typename std::vector<T,A>::const_iterator i=v.begin();
 					i!=v.end();++i,++c) {
+				XMLSERIAL_OBSERVE_SAVE(S,namestr(),"",os);
 				XMLTagInfo fields;
 				SaveWrapper(*i,fields,os,indent+1);
 			}
@@ -77,6 +79,7 @@ namespace XMLSERIALNAMESPACE {
 					}
 					throw streamexception(std::string("Stream Input Format Error: expected end tag for ")+namestr()+", received end tag for "+eleminfo.name);
 				}
+				XMLSERIAL_OBSERVE_LOAD(S,namestr(),"",is);
 				if (i>=n) v.resize(n=i+1);
 				LoadWrapper(v[i++],eleminfo,is);
 			}
@@ -94,14 +97,21 @@ namespace XMLSERIALNAMESPACE {
 		template<typename S>
 		inline static void addotherattr(XMLTagInfo &fields, const std::vector<T,A> &v, S &os) {
 			fields.attr["nelem"] = T2str(v.size());
+			if (BulkIO<T>::active(os)) fields.attr["enc"] = "b64";
 		}
 		inline static bool isshort(const std::vector<T,A> &) { return false; }
 		inline static bool isinline(const std::vector<T,A> &) { return false; }
 		template<typename S>
 		inline static void save(const std::vector<T,A> &v,
 				S &os, int indent) {
-			for(typename std::vector<T,A>::const_iterator i=v.begin();i!=v.end();++i)
-				os << *i << ' ';
+			if (BulkIO<T>::active(os)) {
+				BulkIO<T>::save(v.empty() ? 0 : &v[0],v.size(),os);
+				return;
+			}
+			for(typename std::vector<T,A>::const_iterator i=v.begin();i!=v.end();++i) {
+				WriteNum(os,*i);
+				os << ' ';
+			}
 		}
 		template<typename S>
 		inline static void load(std::vector<T,A> &v, const XMLTagInfo &info,
@@ -112,8 +122,110 @@ namespace XMLSERIALNAMESPACE {
 				throw streamexception("Stream Input Format Error: vector needs nelem attribute");
 			int n = atoi(ni->second.c_str());
 			v.resize(n);
-			for(int i=0;i<n;i++)
-				is >> v[i];
+			if (IsB64(info)) BulkIO<T>::load(n ? &v[0] : 0,n,is);
+			else TextIO<T>::load(v.begin(),n,is);
+			ReadEndTag(is,namestr());
+		}
+	};
+
+	// vector<bool> is written as its bits, packed 8 to a byte (first
+	// element in the lowest bit) and base64 encoded.  nbits gives the size.
+	template<typename A>
+	struct TypeInfo<std::vector<bool,A>,void> {
+		// bytes per block: a multiple of 3 (for base64)
+		enum { BLOCK = 3*8*256 };
+
+		inline static const char *namestr() {
+			static char *ret = TName("vector",1,TypeInfo<bool>::namestr());
+			return ret;
+		}
+		template<typename S>
+		inline static void addotherattr(XMLTagInfo &fields, const std::vector<bool,A> &v, S &os) {
+			fields.attr["nbits"] = T2str(v.size());
+			fields.attr["enc"] = "b64";
+		}
+		inline static bool isshort(const std::vector<bool,A> &) { return false; }
+		inline static bool isinline(const std::vector<bool,A> &) { return false; }
+		template<typename S>
+		inline static void save(const std::vector<bool,A> &v,
+				S &os, int indent) {
+			unsigned char in[BLOCK];
+			char out[BLOCK/3*4];
+			for(std::size_t pos=0,nbits=v.size();pos<nbits;) {
+				std::size_t nb = nbits-pos<8*BLOCK ? nbits-pos
+					: std::size_t(8*BLOCK);
+				std::size_t k = (nb+7)/8;
+				// (through the iterators:  how the library packs its
+				// bits is its own business)
+				typename std::vector<bool,A>::const_iterator i
+					= v.begin()+pos;
+				for(std::size_t j=0,l=0;j<k;j++) {
+					unsigned char c = 0;
+					for(int b=0;b<8 && l<nb;b++,l++,++i)
+						if (*i) c |= (unsigned char)(1<<b);
+					in[j] = c;
+				}
+				pos += nb;
+				B64Encode(in,k,out);
+				os.write(out,B64Len(k));
+			}
+		}
+		template<typename S>
+		inline static void load(std::vector<bool,A> &v, const XMLTagInfo &info,
+				S &is) {
+			std::map<std::string,std::string>::const_iterator ni
+				= info.attr.find("nbits");
+			if (ni == info.attr.end()) {
+				loadtext(v,info,is);
+				return;
+			}
+			if (!IsB64(info))
+				throw streamexception("Stream Input Format Error: vector of bits needs enc=\"b64\"");
+			std::size_t nbits = strtoul(ni->second.c_str(),0,10);
+			if (nbits>v.max_size())
+				throw streamexception("Stream Input Format Error: too many bits ("+ni->second+") for a vector");
+			// the vector grows a block at a time as the data is read,
+			// so a wrong nbits cannot make it larger than the data
+			v.clear();
+			unsigned char out[BLOCK];
+			char in[BLOCK/3*4];
+			IgnoreWS(is);
+			for(std::size_t pos=0;pos<nbits;) {
+				std::size_t nb = nbits-pos<8*BLOCK ? nbits-pos
+					: std::size_t(8*BLOCK);
+				std::size_t k = (nb+7)/8;
+				std::size_t nchar = B64Len(k);
+				is.read(in,nchar);
+				if (is.fail() || (std::size_t)is.gcount()!=nchar
+						|| B64Decode(in,nchar,out)!=(long)k)
+					throw streamexception("Stream Input Format Error: malformed or short base64 bit data");
+				v.resize(pos+nb);
+				typename std::vector<bool,A>::iterator i
+					= v.begin()+pos;
+				for(std::size_t l=0;l<nb;l++,++i)
+					*i = (out[l/8]>>(l%8))&1;
+				pos += nb;
+			}
+			ReadEndTag(is,namestr());
+		}
+
+		// the form written before bits were packed: one 0 or 1 per element
+		template<typename S>
+		inline static void loadtext(std::vector<bool,A> &v,
+				const XMLTagInfo &info, S &is) {
+			std::map<std::string,std::string>::const_iterator ni
+				= info.attr.find("nelem");
+			if (ni == info.attr.end())
+				throw streamexception("Stream Input Format Error: vector needs nbits or nelem attribute");
+			int n = atoi(ni->second.c_str());
+			v.resize(n);
+			for(int i=0;i<n;i++) {
+				bool b;
+				is >> b;
+				if (is.fail())
+					throw streamexception(std::string("Stream Input Format Error: expected ")+T2str(n)+" elements in array, received only "+T2str(i));
+				v[i] = b;
+			}
 			ReadEndTag(is,namestr());
 		}
 	};